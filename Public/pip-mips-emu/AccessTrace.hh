@@ -0,0 +1,166 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_ACCESS_TRACE_HH
+#define PIP_MIPS_EMU_ACCESS_TRACE_HH
+
+#include <pip-mips-emu/AsyncWriter.hh>
+#include <pip-mips-emu/MemoryLevel.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Magic number at the beginning of memory access traces
+/// </summary>
+constexpr char AccessTraceFileMagic[4] { '\x7F', 'P', 'M', 'A' };
+
+/// <summary>
+/// Version of the format written by <c>AccessTraceWriter</c>
+/// </summary>
+constexpr uint32_t AccessTraceFileVersion = 1;
+
+/// <summary>
+/// Size of the header of memory access traces. The header consists of the magic number followed
+/// by the version, which is a little endian word. Records follow the header.
+///
+/// A record begins with a byte whose bits 0-1 are the <c>AccessKind</c> and bits 2-3 are the
+/// base 2 logarithm of the size. LEB128 varints follow it: the cycle minus the cycle of the
+/// previous record, and the zigzag encoded PC minus the PC of the previous record. Loads and
+/// stores end with the zigzag encoded address minus the address of the previous load or store.
+/// The address of a fetch is its PC.
+/// </summary>
+constexpr size_t AccessTraceFileHeaderSize = 8;
+
+/// <summary>
+/// Memory access of an instruction
+/// </summary>
+struct AccessRecord
+{
+    AccessKind kind;
+
+    /// <summary>
+    /// Size of the access in bytes, which is 1 or 4
+    /// </summary>
+    uint32_t size;
+
+    uint32_t pc, address;
+
+    /// <summary>
+    /// The cycle of the access, counted from 1 as printed by runfile
+    /// </summary>
+    uint64_t cycle;
+};
+
+/// <summary>
+/// Records the accesses reported by the stages, which are the ones they pass to their
+/// <c>MemoryLevel</c>s whether or not they have them. Nothing is recorded for the cycles in which
+/// the stages wait for a miss, and the refetch after a miss is recorded again as the memory level
+/// sees it. The records are encoded into a buffer, which is queued to an <c>AsyncWriter</c> when
+/// it fills.
+/// </summary>
+class AccessTraceWriter : public EmulatorObserver
+{
+  public:
+    /// <summary>
+    /// Number of the bytes buffered before they are queued to the writer
+    /// </summary>
+    static constexpr size_t BufferSize = 1 << 16;
+
+  private:
+    AsyncWriter&      _writer;
+    uint64_t          _cycle, _lastCycle;
+    uint32_t          _lastPC, _lastAddress;
+    std::vector<char> _buffer;
+    size_t            _bufferSize;
+    uint64_t          _numRecords;
+
+  public:
+    /// <summary>
+    /// Queues the header to the given writer, which must outlive this writer.
+    /// </summary>
+    /// <exception cref="std::runtime_error">Thrown when the header is dropped.</exception>
+    explicit AccessTraceWriter(AsyncWriter& writer);
+
+  public:
+    uint64_t GetNumRecords() const noexcept
+    {
+        return _numRecords;
+    }
+
+  public:
+    void OnCycleBegin(Memory const&) noexcept
+    {
+        ++_cycle;
+    }
+
+    /// <exception cref="std::runtime_error">Thrown when the buffered records are
+    /// dropped.</exception>
+    void OnMemoryAccess(StageAccess const& access);
+
+  public:
+    /// <summary>
+    /// Queues the buffered records.
+    /// </summary>
+    /// <exception cref="std::runtime_error">Thrown when the records are dropped.</exception>
+    void Flush();
+
+  private:
+    void Append(AccessKind kind, uint32_t size, uint32_t pc, uint32_t address) noexcept;
+};
+
+/// <summary>
+/// Reads the records of a memory access trace one by one.
+/// </summary>
+class AccessTraceReader
+{
+  private:
+    std::istream& _stream;
+    AccessRecord  _last;
+
+  public:
+    /// <summary>
+    /// Reads the header of the given trace.
+    /// </summary>
+    /// <exception cref="std::runtime_error">Thrown when the trace is invalid.</exception>
+    explicit AccessTraceReader(std::istream& stream);
+
+  public:
+    /// <summary>
+    /// Reads the next record. Returns <c>false</c> at the end of the trace.
+    /// </summary>
+    /// <exception cref="std::runtime_error">Thrown when the record is invalid.</exception>
+    bool Next(AccessRecord& record);
+
+  private:
+    uint64_t ReadVarint();
+};
+
+/// <summary>
+/// Results of <c>ReplayAccessTrace</c>
+/// </summary>
+struct AccessReplayStats
+{
+    uint64_t fetches = 0, loads = 0, stores = 0;
+
+    /// <summary>
+    /// Sums of the penalties returned by the memory levels
+    /// </summary>
+    uint64_t instructionStallCycles = 0, dataStallCycles = 0;
+};
+
+/// <summary>
+/// Passes the accesses of the given trace to the given memory levels, either of which may be
+/// <c>nullptr</c>, in the order the pipeline passed them. The data level is ticked once a cycle
+/// before its accesses as <c>MemoryAccess</c> does, so the levels end in the same state as the
+/// ones of the emulation when the trace was recorded with them.
+/// </summary>
+/// <exception cref="std::runtime_error">Thrown when the trace is invalid.</exception>
+AccessReplayStats ReplayAccessTrace(std::istream& stream,
+                                    MemoryLevel*  instructionLevel,
+                                    MemoryLevel*  dataLevel);
+
+#endif
@@ -0,0 +1,106 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_ALLOCATIONS_HH
+#define PIP_MIPS_EMU_ALLOCATIONS_HH
+
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/// <summary>
+/// <c>true</c> if the library replaces the global <c>operator new</c> to count allocations,
+/// which is enabled by the CMake option <c>ENABLE_PIP_MIPS_EMU_ALLOCATION_COUNTING</c>
+/// </summary>
+#if defined(PIP_MIPS_EMU_COUNT_ALLOCATIONS)
+constexpr bool AllocationCountingEnabled = true;
+#else
+constexpr bool AllocationCountingEnabled = false;
+#endif
+
+/// <summary>
+/// Numbers of the allocations and the allocated bytes
+/// </summary>
+struct AllocationCounts
+{
+    uint64_t allocations = 0;
+    uint64_t bytes       = 0;
+};
+
+/// <summary>
+/// Returns the allocations of the calling thread so far. Always 0 unless
+/// <c>AllocationCountingEnabled</c>.
+/// </summary>
+AllocationCounts GetAllocationCounts() noexcept;
+
+/// <summary>
+/// Phases of a cycle whose allocations are reported by <c>AllocationProfiler</c>
+/// </summary>
+enum class AllocationPhase : uint8_t
+{
+    Controllers,
+
+    /// <summary>
+    /// Datapaths run before the control signals are final
+    /// </summary>
+    TickDatapaths,
+
+    ApplyDeltas,
+
+    /// <summary>
+    /// Datapaths run after the control signals are final, including the ones without preference
+    /// </summary>
+    TockDatapaths,
+
+    Handler,
+};
+
+constexpr size_t NumAllocationPhases = static_cast<size_t>(AllocationPhase::Handler) + 1;
+
+/// <summary>
+/// Attributes the allocations of <c>Emulator::TickTock</c> to its phases, using the parts
+/// reported by <c>OnHostTicks</c>. The allocations between two parts are attributed to the later
+/// one, so the allocations of other observers are included unless this profiler is used alone.
+/// </summary>
+class AllocationProfiler : public EmulatorObserver
+{
+  private:
+    size_t                                            _numTickDatapaths;
+    AllocationCounts                                  _last;
+    std::array<AllocationCounts, NumAllocationPhases> _phases;
+    uint64_t                                          _cycles;
+
+  public:
+    explicit AllocationProfiler(Emulator const& emulator) noexcept;
+
+  public:
+    AllocationCounts const& GetCounts(AllocationPhase phase) const noexcept
+    {
+        return _phases[static_cast<size_t>(phase)];
+    }
+
+    uint64_t GetCycles() const noexcept
+    {
+        return _cycles;
+    }
+
+  public:
+    void OnHostTicks(HostPhase phase, size_t index, uint64_t ticks) noexcept;
+
+    void OnCycleEnd(Memory const&) noexcept
+    {
+        ++_cycles;
+    }
+
+  public:
+    /// <summary>
+    /// Prints the allocations and the bytes of each phase per emulated cycle.
+    /// </summary>
+    void WriteReport(std::ostream& stream) const;
+};
+
+#endif
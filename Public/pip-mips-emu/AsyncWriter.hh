@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_ASYNC_WRITER_HH
+#define PIP_MIPS_EMU_ASYNC_WRITER_HH
+
+#include <pip-mips-emu/RingBuffer.hh>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+
+/// <summary>
+/// Identifies what <c>AsyncWriter::Write</c> does when the ring buffer is full.
+/// </summary>
+enum class OverflowPolicy : uint8_t
+{
+    /// <summary>
+    /// Waits until the writer thread frees enough space.
+    /// </summary>
+    Block,
+
+    /// <summary>
+    /// Discards the given bytes and counts them.
+    /// </summary>
+    Drop,
+};
+
+/// <summary>
+/// Describes the ring buffer of an <c>AsyncWriter</c>.
+/// </summary>
+struct AsyncWriterConfig
+{
+    /// <summary>
+    /// Size of the ring buffer in bytes. Must be a power of two.
+    /// </summary>
+    size_t capacity = 1 << 22;
+
+    OverflowPolicy policy = OverflowPolicy::Block;
+};
+
+/// <summary>
+/// Counters of an <c>AsyncWriter</c>.
+/// </summary>
+struct AsyncWriterStats
+{
+    /// <summary>
+    /// Bytes written to the file
+    /// </summary>
+    uint64_t writtenBytes = 0;
+
+    /// <summary>
+    /// Bytes discarded because the ring buffer was full
+    /// </summary>
+    uint64_t droppedBytes = 0;
+
+    /// <summary>
+    /// Calls to <c>Write</c> which had to wait for the writer thread
+    /// </summary>
+    uint64_t blockedWrites = 0;
+};
+
+/// <summary>
+/// Writes bytes to a file on a dedicated thread. The thread which calls <c>Write</c> only copies
+/// the bytes into a lock-free ring buffer, which the writer thread drains in large blocks.
+/// </summary>
+class AsyncWriter
+{
+  private:
+    SpscRingBuffer<char>  _ring;
+    OverflowPolicy        _policy;
+    int                   _fd;
+    std::atomic<bool>     _closing, _failed;
+    std::atomic<uint64_t> _writtenBytes;
+    uint64_t              _droppedBytes, _blockedWrites;
+    std::thread           _thread;
+
+  public:
+    /// <summary>
+    /// Creates the file and starts the writer thread.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the capacity is invalid.</exception>
+    /// <exception cref="std::runtime_error">Thrown when the file cannot be created.</exception>
+    AsyncWriter(std::filesystem::path const& path, AsyncWriterConfig const& config);
+
+    AsyncWriter(AsyncWriter const&) = delete;
+    AsyncWriter& operator=(AsyncWriter const&) = delete;
+
+    /// <summary>
+    /// Waits until all bytes are written unless <c>Close</c> is called.
+    /// </summary>
+    ~AsyncWriter();
+
+  public:
+    /// <summary>
+    /// Returns the counters. <c>writtenBytes</c> is exact only after <c>Close</c> is called.
+    /// </summary>
+    AsyncWriterStats GetStats() const noexcept;
+
+  public:
+    /// <summary>
+    /// Queues the given bytes. Returns <c>false</c> if they are dropped by
+    /// <c>OverflowPolicy::Drop</c>.
+    /// </summary>
+    bool Write(char const* data, size_t size);
+
+    /// <summary>
+    /// Waits until all queued bytes are written and closes the file.
+    /// </summary>
+    /// <exception cref="std::runtime_error">Thrown when the bytes could not be written.</exception>
+    void Close();
+
+  private:
+    void Drain() noexcept;
+};
+
+#endif
@@ -0,0 +1,159 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_CACHE_HH
+#define PIP_MIPS_EMU_CACHE_HH
+
+#include <pip-mips-emu/MemoryLevel.hh>
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Identifies which line is evicted when a set is full.
+/// </summary>
+enum class ReplacementPolicy : uint8_t
+{
+    LRU,
+    Random,
+};
+
+/// <summary>
+/// Identifies how stores are propagated to the next level.
+/// </summary>
+enum class WritePolicy : uint8_t
+{
+    /// <summary>
+    /// Write-allocate. Dirty lines are written to the next level when evicted.
+    /// </summary>
+    WriteBack,
+
+    /// <summary>
+    /// No-write-allocate. Every store is written to the next level.
+    /// </summary>
+    WriteThrough,
+};
+
+/// <summary>
+/// Describes the geometry and policies of a <c>Cache</c>.
+/// </summary>
+struct CacheConfig
+{
+    /// <summary>
+    /// Total capacity in bytes. Must be a power of two.
+    /// </summary>
+    uint32_t size = 4096;
+
+    /// <summary>
+    /// Number of lines in a set.
+    /// </summary>
+    uint32_t associativity = 1;
+
+    /// <summary>
+    /// Size of a line in bytes. Must be a power of two not less than 4.
+    /// </summary>
+    uint32_t lineSize = 32;
+
+    ReplacementPolicy replacement = ReplacementPolicy::LRU;
+    WritePolicy       writePolicy = WritePolicy::WriteBack;
+
+    /// <summary>
+    /// Number of cycles the pipeline waits for each transfer from or to the next level. Ignored if
+    /// the cache is backed by another <c>MemoryLevel</c>.
+    /// </summary>
+    uint32_t missPenalty = 10;
+};
+
+/// <summary>
+/// Hit and miss counters of a <c>Cache</c>.
+/// </summary>
+struct CacheStats
+{
+    uint64_t readHits    = 0;
+    uint64_t readMisses  = 0;
+    uint64_t writeHits   = 0;
+    uint64_t writeMisses = 0;
+    uint64_t writeBacks  = 0;
+
+    uint64_t GetHits() const noexcept
+    {
+        return readHits + writeHits;
+    }
+
+    uint64_t GetMisses() const noexcept
+    {
+        return readMisses + writeMisses;
+    }
+
+    uint64_t GetAccesses() const noexcept
+    {
+        return GetHits() + GetMisses();
+    }
+};
+
+/// <summary>
+/// Timing model of a set-associative cache. Only tags are tracked.
+/// </summary>
+class Cache : public MemoryLevel
+{
+  private:
+    struct Line
+    {
+        uint64_t lastUse;
+        uint32_t tag;
+        bool     valid;
+        bool     dirty;
+    };
+
+  private:
+    CacheConfig       _config;
+    MemoryLevelPtr    _next;
+    uint32_t          _offsetBits, _setMask;
+    std::vector<Line> _lines;
+    uint64_t          _clock, _random;
+    CacheStats        _stats;
+
+  public:
+    /// <summary>
+    /// Creates an empty cache.
+    /// </summary>
+    /// <param name="config">The geometry and policies of the cache</param>
+    /// <param name="next">The level which serves misses. If <c>nullptr</c> is given, each
+    /// transfer takes <c>CacheConfig::missPenalty</c> cycles.</param>
+    /// <exception cref="std::invalid_argument">Thrown when the geometry is invalid.</exception>
+    explicit Cache(CacheConfig const& config, MemoryLevelPtr next = nullptr);
+
+  public:
+    CacheConfig const& GetConfig() const noexcept
+    {
+        return _config;
+    }
+
+    CacheStats const& GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+  public:
+    /// <summary>
+    /// Looks up the line containing the given address and updates the replacement state.
+    /// </summary>
+    virtual uint32_t Access(uint32_t address, AccessType type) noexcept override;
+
+    /// <summary>
+    /// Advances the next level by one cycle.
+    /// </summary>
+    virtual void Tick() noexcept override;
+
+    /// <summary>
+    /// Invalidates all lines and clears the counters.
+    /// </summary>
+    void Reset() noexcept;
+
+  private:
+    Line& SelectVictim(Line* set) noexcept;
+
+    uint32_t Transfer(uint32_t address, AccessType type) noexcept;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #ifndef PIP_MIPS_EMU_COMMON_HH
 #define PIP_MIPS_EMU_COMMON_HH
 
+#include <cstddef>
 #include <cstdint>
 
 /// <summary>
@@ -11,4 +12,45 @@
 /// </summary>
 bool ParseWord(char const* begin, char const* end, uint32_t& out) noexcept;
 
+/// <summary>
+/// Calculates the 64-bit xxHash (XXH64) of the given bytes.
+/// </summary>
+uint64_t Hash64(void const* data, size_t size, uint64_t seed = 0) noexcept;
+
+constexpr bool IsPowerOfTwo(uint32_t value) noexcept
+{
+    return value && !(value & (value - 1));
+}
+
+/// <summary>
+/// Returns the base 2 logarithm of the given value rounded down, or 0 if the value is 0.
+/// </summary>
+constexpr uint32_t Log2(uint32_t value) noexcept
+{
+    uint32_t rtn = 0;
+    while (value >>= 1) ++rtn;
+    return rtn;
+}
+
+/// <summary>
+/// Writes a word in little endian, which the binary files written by the emulator use.
+/// </summary>
+inline void PutLittleEndianWord(char* ptr, uint32_t word) noexcept
+{
+    ptr[0] = static_cast<char>((word >> 0) & 0xFF);
+    ptr[1] = static_cast<char>((word >> 8) & 0xFF);
+    ptr[2] = static_cast<char>((word >> 16) & 0xFF);
+    ptr[3] = static_cast<char>((word >> 24) & 0xFF);
+}
+
+/// <summary>
+/// Reads a word written by <c>PutLittleEndianWord</c>.
+/// </summary>
+inline uint32_t GetLittleEndianWord(char const* ptr) noexcept
+{
+    uint8_t const* bytes = reinterpret_cast<uint8_t const*>(ptr);
+    return static_cast<uint32_t>(bytes[0]) << 0 | static_cast<uint32_t>(bytes[1]) << 8
+           | static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
 #endif
\ No newline at end of file
@@ -4,9 +4,12 @@
 #ifndef PIP_MIPS_EMU_COMPONENTS_HH
 #define PIP_MIPS_EMU_COMPONENTS_HH
 
+#include <pip-mips-emu/MemoryLevel.hh>
 #include <pip-mips-emu/NamedEntryMap.hh>
 
+#include <array>
 #include <memory>
+#include <vector>
 
 /// <summary>
 /// Represents a change in memory.
@@ -37,6 +40,11 @@ struct Delta
         ///
         /// </summary>
         MemoryByte,
+
+        /// <summary>
+        /// Register value change suppressed when a control signal has the given value
+        /// </summary>
+        Unless,
     };
 
     /// <summary>
@@ -55,7 +63,8 @@ struct Delta
     uint32_t signal;
 
     /// <summary>
-    /// This delta is applied if and only if the signal has this value
+    /// This delta is applied if and only if the signal has this value (or does not have this value
+    /// if the type is <c>Type::Unless</c>)
     /// </summary>
     uint16_t condition;
 
@@ -81,6 +90,18 @@ struct Delta
         return Delta { idx, value, signal, static_cast<uint16_t>(condition), Type::Conditioned };
     }
 
+    template <
+        typename ConditionType,
+        std::enable_if_t<
+            (std::is_enum_v<
+                 ConditionType> && std::is_same_v<std::underlying_type_t<ConditionType>, uint16_t>)
+                || (std::is_same_v<ConditionType, uint16_t>),
+            int> = 0>
+    static Delta Unless(uint32_t idx, uint32_t value, uint32_t signal, ConditionType condition)
+    {
+        return Delta { idx, value, signal, static_cast<uint16_t>(condition), Type::Unless };
+    }
+
     static Delta MemoryWord(uint32_t address, uint32_t value)
     {
         return Delta { address, value, 0, 0, Type::MemoryWord };
@@ -104,6 +125,9 @@ enum class TickTockType
 /// </summary>
 class Datapath
 {
+  private:
+    std::vector<StageAccess>* _accessLog = nullptr;
+
   public:
     virtual ~Datapath() = default;
 
@@ -125,6 +149,26 @@ class Datapath
     /// <param name="memory">The current state of the device</param>
     /// <returns>List of deltas</returns>
     virtual std::vector<Delta> Execute(Memory const& memory) const = 0;
+
+    /// <summary>
+    /// Makes <c>Execute</c> append the memory accesses of the datapath to the given log. Nothing
+    /// is appended if <c>nullptr</c> is given, which is the default.
+    /// </summary>
+    void SetAccessLog(std::vector<StageAccess>* accessLog) noexcept
+    {
+        _accessLog = accessLog;
+    }
+
+  protected:
+    /// <summary>
+    /// Reports a memory access to the log if any. Implementers call this function where they
+    /// access the memory, so that the accesses can be observed without another delta.
+    /// </summary>
+    void ReportAccess(AccessKind kind, uint32_t pc, uint32_t address, uint32_t size) const
+    {
+        if (_accessLog)
+            _accessLog->push_back(StageAccess { kind, pc, address, size });
+    }
 };
 
 using DatapathPtr = std::unique_ptr<Datapath>;
@@ -146,6 +190,12 @@ using DatapathPtr = std::unique_ptr<Datapath>;
         rtn.push_back(Delta::Register((to), registerValue));                                       \
     }
 
+#define FORWARD_REGISTER_UNLESS(from, to, signal, condition)                                       \
+    {                                                                                              \
+        uint32_t const registerValue = memory.GetRegister((from));                                 \
+        rtn.push_back(Delta::Unless((to), registerValue, (signal), (condition)));                  \
+    }
+
 #define DEFINE_DELTAS() std::vector<Delta> rtn
 
 #define ADD_DELTA(delta) rtn.push_back((delta))
@@ -238,6 +288,14 @@ using ControllerPtr = std::unique_ptr<Controller>;
 /// </summary>
 class Handler
 {
+  public:
+    /// <summary>
+    /// Number of pipeline stages whose PCs are reported
+    /// </summary>
+    constexpr static uint32_t NumStages = 5;
+
+    using PCs = std::array<uint32_t, NumStages>;
+
   public:
     virtual ~Handler() = default;
 
@@ -258,6 +316,11 @@ class Handler
     /// </summary>
     virtual uint32_t CalcNumInstructions(Memory const& memory) noexcept = 0;
 
+    /// <summary>
+    /// Returns PCs in each pipeline stage as printed by <c>DumpPCs</c>. An empty stage has 0.
+    /// </summary>
+    virtual PCs GetPCs(Memory const& memory) noexcept = 0;
+
     /// <summary>
     /// Prints contents of PCs in each pipeline stage.
     /// </summary>
@@ -281,6 +344,7 @@ using HandlerPtr = std::unique_ptr<Handler>;
     virtual void     Initialize(RegisterMap& regMap, SignalMap& sigMap) override;                  \
     virtual bool     IsTerminated(Memory const& memory) noexcept override;                         \
     virtual uint32_t CalcNumInstructions(Memory const& memory) noexcept;                           \
+    virtual PCs      GetPCs(Memory const& memory) noexcept override;                               \
     virtual void     DumpPCs(Memory const& memory, std::ostream& ostream) override;                \
     virtual void     DumpRegisters(Memory const& memory, std::ostream& stream) override;           \
     virtual void     DumpMemory(Memory const& memory, Range range, std::ostream& stream) override;
@@ -292,6 +356,9 @@ using HandlerPtr = std::unique_ptr<Handler>;
 #define HANDLER_CALC_NUM_INSTRS(ClassName)                                                         \
     uint32_t ClassName::CalcNumInstructions(Memory const& memory) noexcept
 
+#define HANDLER_GET_PCS(ClassName)                                                                 \
+    Handler::PCs ClassName::GetPCs(Memory const& memory) noexcept
+
 #define HANDLER_DUMP_PCS(ClassName)                                                                \
     void ClassName::DumpPCs(Memory const& memory, std::ostream& stream)
 
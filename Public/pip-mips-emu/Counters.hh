@@ -0,0 +1,225 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_COUNTERS_HH
+#define PIP_MIPS_EMU_COUNTERS_HH
+
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Counters of the pipeline. Stalls and flushes are attributed to their causes by the
+/// <c>pipelineState</c> and <c>nextPCType</c> signals of each cycle. Every cycle either commits
+/// an instruction or is lost by exactly one cause, so <c>cycles</c> equals the sum of
+/// <c>instructions</c>, <c>GetStallCycles</c>, <c>GetFlushCycles</c> and <c>fillCycles</c>.
+/// </summary>
+struct PipelineCounters
+{
+    uint64_t cycles       = 0;
+    uint64_t instructions = 0;
+
+    /// <summary>
+    /// Cycles without a committed instruction while the pipeline is being filled or drained.
+    /// Cycles committing <c>nop</c> are also counted.
+    /// </summary>
+    uint64_t fillCycles = 0;
+
+    /// <summary>
+    /// Cycles stalled because an instruction in ID uses the result of a load in EX
+    /// </summary>
+    uint64_t loadUseStalls = 0;
+
+    /// <summary>
+    /// Cycles stalled while a slow memory access is being served
+    /// </summary>
+    uint64_t memoryStalls = 0;
+
+    /// <summary>
+    /// Flushes of the instruction in IF by a jump in ID
+    /// </summary>
+    uint64_t jumpFlushes = 0;
+
+    /// <summary>
+    /// Flushes of the instruction in IF by a branch resolved in ID
+    /// </summary>
+    uint64_t branchFlushes = 0;
+
+    /// <summary>
+    /// Flushes of the instructions in IF, ID and EX by a branch mispredicted in MEM
+    /// </summary>
+    uint64_t mispredictionFlushes = 0;
+
+    /// <summary>
+    /// Cycles lost by each kind of flush. Like the stall cycles, a bubble is counted when it
+    /// reaches the write back stage, and a bubble discarded by a flush is counted for the flush.
+    /// </summary>
+    uint64_t jumpFlushCycles = 0, branchFlushCycles = 0, mispredictionFlushCycles = 0;
+
+    uint64_t GetStallCycles() const noexcept
+    {
+        return loadUseStalls + memoryStalls;
+    }
+
+    uint64_t GetFlushes() const noexcept
+    {
+        return jumpFlushes + branchFlushes + mispredictionFlushes;
+    }
+
+    uint64_t GetFlushCycles() const noexcept
+    {
+        return jumpFlushCycles + branchFlushCycles + mispredictionFlushCycles;
+    }
+
+    double GetCPI() const noexcept
+    {
+        return instructions ? static_cast<double>(cycles) / instructions : 0.0;
+    }
+};
+
+/// <summary>
+/// Identifies why a pipeline slot reaching WB does or does not commit an instruction.
+/// </summary>
+enum class SlotCause : uint8_t
+{
+    /// <summary>
+    /// A fetched instruction. It is not committed only if it is <c>nop</c>.
+    /// </summary>
+    Instruction,
+
+    /// <summary>
+    /// A bubble while the pipeline is being filled or drained
+    /// </summary>
+    Fill,
+
+    LoadUse,
+    Memory,
+    Jump,
+    Branch,
+    Misprediction,
+};
+
+/// <summary>
+/// Content of a pipeline latch as seen by <c>PipelineTracker</c>
+/// </summary>
+struct PipelineSlot
+{
+    SlotCause cause;
+
+    /// <summary>
+    /// The PC of the fetched instruction, or the PC of the instruction which caused the bubble.
+    /// 0 if the bubble is not caused by an instruction.
+    /// </summary>
+    uint32_t pc;
+
+    /// <summary>
+    /// Number of the instructions fetched before the fetched instruction. Unused for bubbles.
+    /// </summary>
+    uint64_t sequence;
+};
+
+/// <summary>
+/// Shadows each latch from IF/ID to WB with the cause of its content, which moves along with the
+/// content following the <c>pipelineState</c> signal. A bubble discarded by a flush is replaced
+/// by a bubble of the flush.
+/// </summary>
+class PipelineTracker
+{
+  private:
+    uint32_t _nextPCType, _pipelineState;
+    uint32_t _ifIdPC, _exMemPC, _memWbPC, _memStallCycles;
+
+    // The state of the current cycle and the slot it inserts
+    PipelineState _state;
+    PipelineSlot  _inserted;
+    uint64_t      _numFetched;
+
+    std::array<PipelineSlot, Handler::NumStages> _slots;
+
+  public:
+    /// <summary>
+    /// Finds the signals and the registers of the given emulator.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the emulator does not have the
+    /// signals and the registers of the default pipeline.</exception>
+    explicit PipelineTracker(Emulator const& emulator);
+
+  public:
+    /// <summary>
+    /// Returns the pipeline state of the current cycle.
+    /// </summary>
+    PipelineState GetState() const noexcept
+    {
+        return _state;
+    }
+
+    /// <summary>
+    /// Returns the cause of the slot inserted in the current cycle.
+    /// </summary>
+    SlotCause GetInsertedCause() const noexcept
+    {
+        return _inserted.cause;
+    }
+
+    /// <summary>
+    /// Returns the slots of IF/ID, ID/EX, EX/MEM, MEM/WB and WB in order.
+    /// </summary>
+    std::array<PipelineSlot, Handler::NumStages> const& GetSlots() const noexcept
+    {
+        return _slots;
+    }
+
+  public:
+    /// <summary>
+    /// Reads the signals of the current cycle. Must be called with the state before the cycle.
+    /// </summary>
+    void Resolve(Memory const& memory, std::vector<uint16_t> const& controls);
+
+    /// <summary>
+    /// Moves the slots as the current cycle does and returns the slot in WB.
+    /// </summary>
+    PipelineSlot const& Advance() noexcept;
+};
+
+/// <summary>
+/// Collects <c>PipelineCounters</c> from the events of an <c>Emulator</c>.
+/// </summary>
+class CounterCollector : public EmulatorObserver
+{
+  private:
+    Handler&         _handler;
+    PipelineTracker  _tracker;
+    PipelineCounters _counters;
+
+  public:
+    /// <summary>
+    /// Finds the signals and the registers of the given emulator. The emulator must outlive the
+    /// collector.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the emulator does not have the
+    /// signals and the registers of the default pipeline.</exception>
+    explicit CounterCollector(Emulator const& emulator);
+
+  public:
+    PipelineCounters const& GetCounters() const noexcept
+    {
+        return _counters;
+    }
+
+  public:
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls);
+
+    void OnCycleEnd(Memory const& memory) noexcept;
+};
+
+/// <summary>
+/// Prints the counters as a JSON object.
+/// </summary>
+void WriteCountersJson(PipelineCounters const& counters, std::ostream& stream);
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_COVERAGE_HH
+#define PIP_MIPS_EMU_COVERAGE_HH
+
+#include <pip-mips-emu/Memory.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Magic number at the beginning of coverage files
+/// </summary>
+constexpr char CoverageFileMagic[4] { '\x7F', 'P', 'M', 'C' };
+
+/// <summary>
+/// Version of the format written by <c>Coverage::Write</c>
+/// </summary>
+constexpr uint32_t CoverageFileVersion = 1;
+
+/// <summary>
+/// Size of the header of coverage files. The header consists of the magic number followed by the
+/// version, the number of the words of the text segment and the hash of the text segment, each of
+/// which is a little endian word. The bitmaps follow the header in the order of
+/// <c>CoverageKind</c>, each of which consists of little endian words whose bit <c>i % 32</c> of
+/// word <c>i / 32</c> is of the instruction at <c>text base + i * 4</c>.
+/// </summary>
+constexpr size_t CoverageFileHeaderSize = 16;
+
+/// <summary>
+/// Bitmaps of <c>Coverage</c>
+/// </summary>
+enum class CoverageKind : uint32_t
+{
+    /// <summary>
+    /// BEQ and BNE of the text segment, which do not depend on runs
+    /// </summary>
+    Branches,
+
+    /// <summary>
+    /// Committed instructions
+    /// </summary>
+    Executed,
+
+    /// <summary>
+    /// Committed branches whose conditions held at least once
+    /// </summary>
+    Taken,
+
+    /// <summary>
+    /// Committed branches whose conditions did not hold at least once
+    /// </summary>
+    NotTaken,
+};
+
+constexpr size_t NumCoverageKinds = static_cast<size_t>(CoverageKind::NotTaken) + 1;
+
+/// <summary>
+/// Returns the FNV-1a hash of the words of the text segment of the given memory, which tells
+/// coverage of different programs apart.
+/// </summary>
+uint32_t HashText(Memory const& memory) noexcept;
+
+/// <summary>
+/// Bitmaps over the words of a text segment, which can be written to files and merged across
+/// runs of the same program
+/// </summary>
+class Coverage
+{
+  private:
+    uint32_t                                            _numWords, _textHash;
+    std::array<std::vector<uint32_t>, NumCoverageKinds> _bitmaps;
+
+  public:
+    /// <summary>
+    /// Creates empty bitmaps of the given number of words.
+    /// </summary>
+    Coverage(uint32_t numWords, uint32_t textHash);
+
+    /// <summary>
+    /// Creates empty bitmaps of the text segment of the given memory, marking its branches.
+    /// </summary>
+    explicit Coverage(Memory const& memory);
+
+  public:
+    uint32_t GetNumWords() const noexcept
+    {
+        return _numWords;
+    }
+
+    uint32_t GetTextHash() const noexcept
+    {
+        return _textHash;
+    }
+
+    bool Test(CoverageKind kind, uint32_t index) const noexcept
+    {
+        return (_bitmaps[static_cast<size_t>(kind)][index / 32] >> (index % 32)) & 1;
+    }
+
+    void Set(CoverageKind kind, uint32_t index) noexcept
+    {
+        _bitmaps[static_cast<size_t>(kind)][index / 32] |= uint32_t { 1 } << (index % 32);
+    }
+
+    /// <summary>
+    /// Returns the number of the words set in the given bitmap.
+    /// </summary>
+    uint32_t Count(CoverageKind kind) const noexcept;
+
+    /// <summary>
+    /// Returns the number of the branches both of whose directions are covered.
+    /// </summary>
+    uint32_t CountBothDirections() const noexcept;
+
+  public:
+    /// <summary>
+    /// Adds the words covered by the given coverage.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the coverage is of another
+    /// program.</exception>
+    void Merge(Coverage const& other);
+
+    void Write(std::ostream& stream) const;
+
+    /// <exception cref="std::runtime_error">Thrown when the file is invalid.</exception>
+    static Coverage Read(std::istream& stream);
+
+    /// <summary>
+    /// Prints the ratios of the covered instructions and branch directions.
+    /// </summary>
+    void WriteSummary(std::ostream& stream) const;
+};
+
+/// <summary>
+/// Marks the committed instructions and the directions of the committed branches. The branches
+/// are found when the collector is created, so marking an instruction other than a branch only
+/// sets a bit.
+/// </summary>
+class CoverageCollector : public EmulatorObserver
+{
+  private:
+    Coverage _coverage;
+
+  public:
+    explicit CoverageCollector(Memory const& memory) : _coverage { memory } {}
+
+  public:
+    Coverage const& GetCoverage() const noexcept
+    {
+        return _coverage;
+    }
+
+  public:
+    void OnInstructionCommitted(Memory const& memory, uint32_t pc) noexcept;
+};
+
+#endif
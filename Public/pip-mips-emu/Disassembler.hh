@@ -0,0 +1,65 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_DISASSEMBLER_HH
+#define PIP_MIPS_EMU_DISASSEMBLER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Groups instructions by the way they use the pipeline.
+/// </summary>
+enum class InstructionClass : uint8_t
+{
+    Nop,
+
+    /// <summary>
+    /// Arithmetic, logical and shift instructions including <c>lui</c>
+    /// </summary>
+    Alu,
+
+    Load,
+    Store,
+    Branch,
+
+    /// <summary>
+    /// <c>j</c>, <c>jal</c> and <c>jr</c>
+    /// </summary>
+    Jump,
+
+    /// <summary>
+    /// Words which are not supported instructions
+    /// </summary>
+    Unknown,
+};
+
+constexpr size_t NumInstructionClasses = static_cast<size_t>(InstructionClass::Unknown) + 1;
+
+/// <summary>
+/// Returns the mnemonic of the given instruction, such as <c>addu</c>, or <c>nullptr</c> if it is
+/// not supported. Only the operation and the function fields are read.
+/// </summary>
+char const* GetMnemonic(uint32_t instruction) noexcept;
+
+/// <summary>
+/// Returns the class of the given instruction.
+/// </summary>
+InstructionClass Classify(uint32_t instruction) noexcept;
+
+/// <summary>
+/// Returns the lowercase name of the given class, such as <c>load</c>.
+/// </summary>
+char const* GetClassName(InstructionClass instructionClass) noexcept;
+
+/// <summary>
+/// Returns the assembly of the given instruction, such as <c>lw $t3, 4($t0)</c>. Branch and jump
+/// targets are written as absolute addresses, and words which are not supported instructions are
+/// written as <c>.word</c> directives.
+/// </summary>
+/// <param name="instruction">The instruction to disassemble</param>
+/// <param name="pc">The address of the instruction</param>
+std::string Disassemble(uint32_t instruction, uint32_t pc);
+
+#endif
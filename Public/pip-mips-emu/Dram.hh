@@ -0,0 +1,149 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_DRAM_HH
+#define PIP_MIPS_EMU_DRAM_HH
+
+#include <pip-mips-emu/MemoryLevel.hh>
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Identifies when a row buffer is closed.
+/// </summary>
+enum class PagePolicy : uint8_t
+{
+    /// <summary>
+    /// The row stays open until another row of the same bank is accessed.
+    /// </summary>
+    Open,
+
+    /// <summary>
+    /// The row is precharged right after each access.
+    /// </summary>
+    Closed,
+};
+
+/// <summary>
+/// Describes the organization and timings of a <c>Dram</c>.
+/// </summary>
+struct DramConfig
+{
+    /// <summary>
+    /// Number of banks. Must be a power of two.
+    /// </summary>
+    uint32_t numBanks = 8;
+
+    /// <summary>
+    /// Size of a row in bytes. Must be a power of two.
+    /// </summary>
+    uint32_t rowSize = 2048;
+
+    PagePolicy pagePolicy = PagePolicy::Open;
+
+    /// <summary>
+    /// Cycles between activating a row and issuing a column command
+    /// </summary>
+    uint32_t tRCD = 14;
+
+    /// <summary>
+    /// Cycles between issuing a column command and receiving the data
+    /// </summary>
+    uint32_t tCAS = 14;
+
+    /// <summary>
+    /// Cycles to precharge (close) an open row
+    /// </summary>
+    uint32_t tRP = 14;
+};
+
+/// <summary>
+/// Row buffer counters of a <c>Dram</c>.
+/// </summary>
+struct DramStats
+{
+    /// <summary>
+    /// Accesses to the open row
+    /// </summary>
+    uint64_t rowHits = 0;
+
+    /// <summary>
+    /// Accesses to a bank without an open row
+    /// </summary>
+    uint64_t rowMisses = 0;
+
+    /// <summary>
+    /// Accesses to a bank with another row open
+    /// </summary>
+    uint64_t rowConflicts = 0;
+
+    /// <summary>
+    /// Sum of the latencies of all accesses
+    /// </summary>
+    uint64_t totalLatency = 0;
+
+    uint64_t GetAccesses() const noexcept
+    {
+        return rowHits + rowMisses + rowConflicts;
+    }
+
+    double GetRowHitRate() const noexcept
+    {
+        uint64_t const accesses = GetAccesses();
+        return accesses ? static_cast<double>(rowHits) / accesses : 0.0;
+    }
+
+    double GetAverageLatency() const noexcept
+    {
+        uint64_t const accesses = GetAccesses();
+        return accesses ? static_cast<double>(totalLatency) / accesses : 0.0;
+    }
+};
+
+/// <summary>
+/// Timing model of a DRAM main memory with per-bank row buffers. Addresses are interleaved as
+/// <c>row:bank:column</c>, so consecutive rows are spread over the banks.
+/// </summary>
+class Dram : public MemoryLevel
+{
+  private:
+    constexpr static uint32_t NoOpenRow = 0xFFFFFFFF;
+
+  private:
+    DramConfig            _config;
+    uint32_t              _columnBits, _bankBits, _bankMask;
+    std::vector<uint32_t> _openRows;
+    DramStats             _stats;
+
+  public:
+    /// <summary>
+    /// Creates a DRAM whose banks are all precharged.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the organization is invalid.</exception>
+    explicit Dram(DramConfig const& config);
+
+  public:
+    DramConfig const& GetConfig() const noexcept
+    {
+        return _config;
+    }
+
+    DramStats const& GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+  public:
+    /// <summary>
+    /// Accesses the row containing the given address and updates the row buffer of its bank.
+    /// </summary>
+    virtual uint32_t Access(uint32_t address, AccessType type) noexcept override;
+
+    /// <summary>
+    /// Precharges all banks and clears the counters.
+    /// </summary>
+    void Reset() noexcept;
+};
+
+#endif
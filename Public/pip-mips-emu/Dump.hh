@@ -0,0 +1,155 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_DUMP_HH
+#define PIP_MIPS_EMU_DUMP_HH
+
+#include <pip-mips-emu/Components.hh>
+#include <pip-mips-emu/Memory.hh>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <string_view>
+
+/// <summary>
+/// Number of general purpose registers printed by <c>WriteRegisters</c>
+/// </summary>
+constexpr uint32_t NumDumpedRegisters = Memory::PC;
+
+/// <summary>
+/// Collects text in a fixed-size buffer and writes it to a stream in large blocks. Numbers are
+/// formatted with <c>std::to_chars</c>, so the formatting flags of the stream are not used.
+/// </summary>
+class TextBuffer
+{
+  public:
+    constexpr static size_t Capacity = 1 << 16;
+
+  private:
+    std::ostream& _stream;
+    size_t        _size;
+    char          _data[Capacity];
+
+  public:
+    explicit TextBuffer(std::ostream& stream) noexcept : _stream { stream }, _size { 0 } {}
+
+    TextBuffer(TextBuffer const&) = delete;
+    TextBuffer& operator=(TextBuffer const&) = delete;
+
+    /// <summary>
+    /// Writes the remaining text to the stream.
+    /// </summary>
+    ~TextBuffer();
+
+  public:
+    void Append(char ch)
+    {
+        Reserve(1);
+        _data[_size++] = ch;
+    }
+
+    void Append(std::string_view text)
+    {
+        if (text.size() > Capacity - _size)
+        {
+            Flush();
+            if (text.size() > Capacity)
+            {
+                WriteToStream(text.data(), text.size());
+                return;
+            }
+        }
+
+        std::memcpy(_data + _size, text.data(), text.size());
+        _size += text.size();
+    }
+
+    /// <summary>
+    /// Appends the given value in lowercase hexadecimal without any prefix.
+    /// </summary>
+    void AppendHex(uint32_t value)
+    {
+        AppendNumber(value, 16);
+    }
+
+    void AppendDecimal(uint32_t value)
+    {
+        AppendNumber(value, 10);
+    }
+
+    /// <summary>
+    /// Writes the buffered text to the stream.
+    /// </summary>
+    void Flush()
+    {
+        if (_size != 0)
+            WriteToStream(_data, _size);
+        _size = 0;
+    }
+
+  private:
+    // Enough for a 32-bit number in any base not less than 10
+    constexpr static size_t MaxNumberSize = 10;
+
+    void Reserve(size_t size)
+    {
+        if (size > Capacity - _size)
+            Flush();
+    }
+
+    void AppendNumber(uint32_t value, int base)
+    {
+        Reserve(MaxNumberSize);
+        char* end = std::to_chars(_data + _size, _data + Capacity, value, base).ptr;
+        _size     = static_cast<size_t>(end - _data);
+    }
+
+    void WriteToStream(char const* data, size_t size);
+};
+
+/// <summary>
+/// Prints PCs in each pipeline stage in the format of <c>DefaultHandler::DumpPCs</c>.
+/// </summary>
+void WritePCs(Handler::PCs const& pcs, TextBuffer& buffer);
+
+void WritePCs(Handler::PCs const& pcs, std::ostream& stream);
+
+/// <summary>
+/// Prints PC and r0 - r31 in the format of <c>DefaultHandler::DumpRegisters</c>.
+/// </summary>
+void WriteRegisters(uint32_t pc, uint32_t const* registers, TextBuffer& buffer);
+
+void WriteRegisters(uint32_t pc, uint32_t const* registers, std::ostream& stream);
+
+/// <summary>
+/// Prints the header of a memory dump in the format of <c>DefaultHandler::DumpMemory</c>.
+/// </summary>
+void WriteMemoryHeader(Range range, TextBuffer& buffer);
+
+void WriteMemoryHeader(Range range, std::ostream& stream);
+
+/// <summary>
+/// Prints consecutive words of a memory dump in the format of <c>DefaultHandler::DumpMemory</c>.
+/// </summary>
+/// <param name="address">The address of the first word</param>
+void WriteMemoryWords(Address address, uint32_t const* words, size_t count, TextBuffer& buffer);
+
+void WriteMemoryWords(Address address, uint32_t const* words, size_t count, std::ostream& stream);
+
+/// <summary>
+/// Returns the number of words printed by <c>DefaultHandler::DumpMemory</c> for the given range.
+/// </summary>
+/// <exception cref="std::invalid_argument">Thrown when the range is invalid.</exception>
+size_t CountMemoryWords(Range range);
+
+/// <summary>
+/// Reads the words printed by <c>DefaultHandler::DumpMemory</c> for the given range.
+/// </summary>
+/// <param name="out">The buffer to write words to, which must hold
+/// <c>CountMemoryWords(range)</c> words</param>
+void ReadMemoryWords(Memory const& memory, Range range, uint32_t* out) noexcept;
+
+#endif
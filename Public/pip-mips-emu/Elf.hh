@@ -0,0 +1,24 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_ELF_HH
+#define PIP_MIPS_EMU_ELF_HH
+
+#include <pip-mips-emu/File.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Magic number at the beginning of ELF files
+/// </summary>
+constexpr char ElfFileMagic[4] { '\x7F', 'E', 'L', 'F' };
+
+/// <summary>
+/// Reads a 32-bit big endian MIPS executable from the given bytes. Each <c>PT_LOAD</c> segment is
+/// copied to the text or the data segment by its virtual address, and the bytes not present in
+/// the file are zero-filled. Symbols are read from the <c>SHT_SYMTAB</c> section if it exists.
+/// </summary>
+FileReadResult ReadElfFile(uint8_t const* bytes, size_t size);
+
+#endif
@@ -5,11 +5,15 @@
 #define PIP_MIPS_EMU_EMULATOR_HH
 
 #include <pip-mips-emu/Components.hh>
+#include <pip-mips-emu/HostTimer.hh>
 #include <pip-mips-emu/Memory.hh>
 #include <pip-mips-emu/NamedEntryMap.hh>
+#include <pip-mips-emu/Observer.hh>
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -46,6 +50,7 @@ class Emulator
     std::unordered_map<std::string, uint32_t> _namedRegisters;
     std::unordered_map<std::string, uint32_t> _namedSignals;
     std::vector<uint16_t>                     _controls;
+    std::vector<StageAccess>                  _accesses;
 
   public:
     HandlerPtr const& GetHandler() const
@@ -53,6 +58,61 @@ class Emulator
         return _handler;
     }
 
+    /// <summary>
+    /// Returns the indices of the registers named by the components, such as <c>IF_ID_PC</c>.
+    /// </summary>
+    std::unordered_map<std::string, uint32_t> const& GetNamedRegisters() const noexcept
+    {
+        return _namedRegisters;
+    }
+
+    /// <summary>
+    /// Returns the indices of the control signals, such as <c>pipelineState</c>.
+    /// </summary>
+    std::unordered_map<std::string, uint32_t> const& GetNamedSignals() const noexcept
+    {
+        return _namedSignals;
+    }
+
+    /// <summary>
+    /// Returns the index of the register of the given name.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when no component names the register,
+    /// which means the emulator does not have the default pipeline.</exception>
+    uint32_t FindRegister(char const* name) const;
+
+    /// <summary>
+    /// Returns the index of the control signal of the given name.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when no component names the signal,
+    /// which means the emulator does not have the default pipeline.</exception>
+    uint32_t FindSignal(char const* name) const;
+
+    /// <summary>
+    /// Returns the class names of the controllers in the order they are executed.
+    /// </summary>
+    std::vector<std::string> GetControllerNames() const;
+
+    /// <summary>
+    /// Returns the number of the datapaths run before the control signals are final, which come
+    /// first in <c>GetDatapathNames</c>.
+    /// </summary>
+    size_t GetNumTickDatapaths() const noexcept
+    {
+        return _tickDatapaths.size();
+    }
+
+    /// <summary>
+    /// Returns the class name of the handler.
+    /// </summary>
+    std::string GetHandlerName() const;
+
+    /// <summary>
+    /// Returns the class names of the datapaths in the order they are executed, which is the
+    /// order of the indices of <c>HostPhase::Datapath</c>.
+    /// </summary>
+    std::vector<std::string> GetDatapathNames() const;
+
   private:
     Emulator(std::vector<std::pair<DatapathPtr, TickTockType>>&& datapaths,
              std::vector<ControllerPtr>&&                        controllers,
@@ -72,14 +132,210 @@ class Emulator
     /// </summary>
     /// <param name="memory">The memory to mutate</param>
     /// <returns>Execution result</returns>
-    TickTockResult TickTock(Memory& memory, uint32_t& num_instr) noexcept;
+    TickTockResult TickTock(Memory& memory, uint32_t& num_instr) noexcept
+    {
+        EmulatorObserver observer;
+        return TickTock(memory, num_instr, observer);
+    }
+
+    /// <summary>
+    /// Runs one instruction and reports the events of the cycle to the given observer. If the
+    /// observer handles <c>OnHostTicks</c>, the host time spent in each component is measured.
+    /// </summary>
+    /// <typeparam name="Observer"><c>EmulatorObserver</c> or a class derived from it</typeparam>
+    template <typename Observer>
+    TickTockResult TickTock(Memory& memory, uint32_t& num_instr, Observer& observer) noexcept;
 
     /// <summary>
     /// Returns <c>true</c> if the program is terminated.
     /// </summary>
     bool IsTerminated(Memory const& memory) const noexcept;
+
+  private:
+    /// <summary>
+    /// Calls the given function, measuring its host time if the observer handles
+    /// <c>OnHostTicks</c>.
+    /// </summary>
+    template <typename Observer, typename Function>
+    static auto Measure(Observer& observer, HostPhase phase, size_t index, Function&& function);
+
+    /// <summary>
+    /// Makes all datapaths append their accesses to the given log, or stop if <c>nullptr</c>.
+    /// </summary>
+    void SetAccessLog(std::vector<StageAccess>* accessLog) noexcept;
+
+    template <typename Observer>
+    void ApplyDeltas(Memory&                                memory,
+                     std::vector<std::vector<Delta>> const& deltaLists,
+                     Observer&                              observer);
 };
 
+template <typename Observer>
+TickTockResult Emulator::TickTock(Memory& memory, uint32_t& num_instr, Observer& observer) noexcept
+{
+    if (Measure(observer, HostPhase::Handler, 0, [&] { return IsTerminated(memory); }))
+        return TickTockResult::AlreadyTerminated;
+
+    try
+    {
+        if constexpr (!IsNullObserver<Observer>)
+            observer.OnCycleBegin(memory);
+
+        // The log is detached before returning, as the emulator may be moved between cycles
+        if constexpr (ObservesMemoryAccesses<Observer>::value)
+        {
+            _accesses.clear();
+            SetAccessLog(&_accesses);
+        }
+
+        std::fill(_controls.begin(), _controls.end(), 0);
+        for (size_t i = 0; i < _controllers.size(); ++i)
+        {
+            auto const controls = Measure(observer, HostPhase::Controller, i, [&] {
+                return _controllers[i]->Execute(memory);
+            });
+            for (auto const& control : controls) _controls[control.signal] = control.value;
+        }
+
+        if constexpr (!IsNullObserver<Observer>)
+            observer.OnControlsResolved(memory, _controls);
+
+        size_t     datapathIdx = 0;
+        auto const execute     = [&](DatapathPtr const& datapath) {
+            return Measure(observer, HostPhase::Datapath, datapathIdx++, [&] {
+                return datapath->Execute(memory);
+            });
+        };
+
+        std::vector<std::vector<Delta>> tickDeltas;
+        for (auto const& datapath : _tickDatapaths) tickDeltas.push_back(execute(datapath));
+
+        Measure(observer, HostPhase::ApplyDeltas, 0, [&] {
+            ApplyDeltas(memory, tickDeltas, observer);
+        });
+
+        std::vector<std::vector<Delta>> tockDeltas;
+        for (auto const& datapath : _datapaths) tockDeltas.push_back(execute(datapath));
+        for (auto const& datapath : _tockDatapaths) tockDeltas.push_back(execute(datapath));
+
+        Measure(observer, HostPhase::ApplyDeltas, 1, [&] {
+            ApplyDeltas(memory, tockDeltas, observer);
+        });
+
+        if constexpr (ObservesMemoryAccesses<Observer>::value)
+        {
+            SetAccessLog(nullptr);
+            for (StageAccess const& access : _accesses) observer.OnMemoryAccess(access);
+        }
+
+        uint32_t const numCommitted = Measure(observer, HostPhase::Handler, 1, [&] {
+            return _handler->CalcNumInstructions(memory);
+        });
+        num_instr += numCommitted;
+
+        if constexpr (ObservesCommits<Observer>::value)
+        {
+            if (numCommitted)
+            {
+                auto const pcs = Measure(observer, HostPhase::Handler, 2, [&] {
+                    return _handler->GetPCs(memory);
+                });
+                observer.OnInstructionCommitted(memory, pcs[Handler::NumStages - 1]);
+            }
+        }
+
+        if constexpr (!IsNullObserver<Observer>)
+            observer.OnCycleEnd(memory);
+
+        return TickTockResult::Success;
+    }
+    catch (std::out_of_range const&)
+    {
+        if constexpr (ObservesMemoryAccesses<Observer>::value)
+            SetAccessLog(nullptr);
+        return TickTockResult::MemoryOutOfRange;
+    }
+    catch (...)
+    {
+        if constexpr (ObservesMemoryAccesses<Observer>::value)
+            SetAccessLog(nullptr);
+        return TickTockResult::UnknownError;
+    }
+}
+
+template <typename Observer, typename Function>
+auto Emulator::Measure(Observer& observer, HostPhase phase, size_t index, Function&& function)
+{
+    if constexpr (!ObservesHostTicks<Observer>::value)
+        return function();
+    else if constexpr (std::is_void_v<decltype(function())>)
+    {
+        uint64_t const begin = ReadHostTicks();
+        function();
+        observer.OnHostTicks(phase, index, ReadHostTicks() - begin);
+    }
+    else
+    {
+        uint64_t const begin  = ReadHostTicks();
+        auto           result = function();
+        observer.OnHostTicks(phase, index, ReadHostTicks() - begin);
+        return result;
+    }
+}
+
+template <typename Observer>
+void Emulator::ApplyDeltas(Memory&                                memory,
+                           std::vector<std::vector<Delta>> const& deltaLists,
+                           Observer&                              observer)
+{
+    for (auto const& deltaList : deltaLists)
+    {
+        for (auto const& delta : deltaList)
+        {
+            bool applied = true;
+            switch (delta.type)
+            {
+            case Delta::Type::Register:
+            {
+                memory.SetRegister(delta.target, delta.value);
+                break;
+            }
+            case Delta::Type::Conditioned:
+            {
+                applied = _controls[delta.signal] == delta.condition;
+                if (applied)
+                    memory.SetRegister(delta.target, delta.value);
+                break;
+            }
+            case Delta::Type::Unless:
+            {
+                applied = _controls[delta.signal] != delta.condition;
+                if (applied)
+                    memory.SetRegister(delta.target, delta.value);
+                break;
+            }
+            case Delta::Type::MemoryWord:
+            {
+                memory.SetWord(Address::MakeFromWord(delta.target), delta.value);
+                break;
+            }
+            case Delta::Type::MemoryByte:
+            {
+                memory.SetByte(Address::MakeFromWord(delta.target),
+                               static_cast<uint8_t>(delta.value));
+                break;
+            }
+            }
+
+            if constexpr (ObservesDeltas<Observer>::value)
+            {
+                if (applied)
+                    observer.OnDeltaApplied(memory, delta);
+            }
+        }
+    }
+}
+
 /// <summary>
 /// Implements builder pattern for <c>Emulator</c>.
 /// </summary>
@@ -100,10 +356,13 @@ class EmulatorBuilder
     /// Adds a datapath component.
     /// </summary>
     /// <typeparam name="T">Type of the component</typeparam>
-    template <typename T, std::enable_if_t<std::is_base_of_v<Datapath, T>, int> = 0>
-    EmulatorBuilder& AddDatapath()
+    /// <param name="args">Arguments passed to the constructor of the component</param>
+    template <typename T,
+              typename... Args,
+              std::enable_if_t<std::is_base_of_v<Datapath, T>, int> = 0>
+    EmulatorBuilder& AddDatapath(Args&&... args)
     {
-        AddDatapath(std::make_unique<T>());
+        AddDatapath(std::make_unique<T>(std::forward<Args>(args)...));
         return *this;
     }
 
@@ -111,10 +370,13 @@ class EmulatorBuilder
     /// Adds a control unit component.
     /// </summary>
     /// <typeparam name="T">Type of the component</typeparam>
-    template <typename T, std::enable_if_t<std::is_base_of_v<Controller, T>, int> = 0>
-    EmulatorBuilder& AddController()
+    /// <param name="args">Arguments passed to the constructor of the component</param>
+    template <typename T,
+              typename... Args,
+              std::enable_if_t<std::is_base_of_v<Controller, T>, int> = 0>
+    EmulatorBuilder& AddController(Args&&... args)
     {
-        AddController(std::make_unique<T>());
+        AddController(std::make_unique<T>(std::forward<Args>(args)...));
         return *this;
     }
 
@@ -122,10 +384,13 @@ class EmulatorBuilder
     /// Adds a handler.
     /// </summary>
     /// <typeparam name="T">Type of the handler</typeparam>
-    template <typename T, std::enable_if_t<std::is_base_of_v<Handler, T>, int> = 0>
-    EmulatorBuilder& AddHandler()
+    /// <param name="args">Arguments passed to the constructor of the handler</param>
+    template <typename T,
+              typename... Args,
+              std::enable_if_t<std::is_base_of_v<Handler, T>, int> = 0>
+    EmulatorBuilder& AddHandler(Args&&... args)
     {
-        AddHandler(std::make_unique<T>());
+        AddHandler(std::make_unique<T>(std::forward<Args>(args)...));
         return *this;
     }
 
@@ -4,11 +4,34 @@
 #ifndef PIP_MIPS_EMU_FILE_HH
 #define PIP_MIPS_EMU_FILE_HH
 
+#include <pip-mips-emu/Memory.hh>
+
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <iosfwd>
+#include <string>
 #include <variant>
 #include <vector>
 
+/// <summary>
+/// Magic number at the beginning of binary executables
+/// </summary>
+constexpr char BinaryFileMagic[4] { '\x7F', 'P', 'M', 'E' };
+
+/// <summary>
+/// Version of the binary executable format written by <c>WriteBinaryFile</c>
+/// </summary>
+constexpr uint32_t BinaryFileVersion = 1;
+
+/// <summary>
+/// Size of the header of binary executables. The header consists of the magic number followed by
+/// the version, the size of the text segment, the size of the data segment and the entry point,
+/// each of which is a big endian word. The raw bytes of the text and data segments follow the
+/// header.
+/// </summary>
+constexpr size_t BinaryFileHeaderSize = 20;
+
 /// <summary>
 /// Represents an error occurred when reading given files.
 /// </summary>
@@ -23,12 +46,45 @@ struct FileReadError
     };
 
     Type type;
+
+    /// <summary>
+    /// Returns a human-readable description of the error.
+    /// </summary>
+    char const* GetMessage() const noexcept;
+};
+
+/// <summary>
+/// Represents a symbol defined in an executable.
+/// </summary>
+struct Symbol
+{
+    enum class Type
+    {
+        NoType,
+        Object,
+        Function,
+    };
+
+    std::string name;
+    uint32_t    value;
+    uint32_t    size;
+    Type        type;
 };
 
 struct CanRead
 {
     std::vector<uint8_t> text;
     std::vector<uint8_t> data;
+
+    /// <summary>
+    /// The initial value of PC
+    /// </summary>
+    uint32_t entryPoint = Address::MakeText(0);
+
+    /// <summary>
+    /// Symbols of the executable. Only ELF executables have symbols.
+    /// </summary>
+    std::vector<Symbol> symbols;
 };
 
 struct CannotRead
@@ -42,7 +98,8 @@ struct CannotRead
 using FileReadResult = std::variant<CanRead, CannotRead>;
 
 /// <summary>
-/// Reads an executable from the given path.
+/// Reads an executable from the given path. Binary and ELF executables are detected by their magic
+/// numbers and mapped into the memory where supported, from which their sections are copied.
 /// </summary>
 FileReadResult ReadFile(std::filesystem::path const& path);
 
@@ -51,4 +108,9 @@ FileReadResult ReadFile(std::filesystem::path const& path);
 /// </summary>
 FileReadResult ReadFile(std::istream& is);
 
+/// <summary>
+/// Writes the given executable in the binary format.
+/// </summary>
+void WriteBinaryFile(CanRead const& file, std::ostream& os);
+
 #endif
\ No newline at end of file
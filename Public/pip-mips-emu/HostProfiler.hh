@@ -0,0 +1,78 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_HOST_PROFILER_HH
+#define PIP_MIPS_EMU_HOST_PROFILER_HH
+
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Host ticks spent in a part of <c>Emulator::TickTock</c>
+/// </summary>
+struct HostProfileEntry
+{
+    std::string name;
+    uint64_t    ticks   = 0;
+    uint64_t    samples = 0;
+};
+
+/// <summary>
+/// Measures the host time spent in each controller, datapath, application of deltas and handler
+/// call of an <c>Emulator</c>, so that slow components can be found. The ticks of each sample
+/// are reduced by the cost of reading the timer, which is measured when the profiler is created.
+/// Applying deltas includes the time of the observers of the deltas.
+/// </summary>
+class HostProfiler : public EmulatorObserver
+{
+  private:
+    std::vector<HostProfileEntry>   _controllers, _datapaths;
+    std::array<HostProfileEntry, 2> _applyDeltas;
+    std::array<HostProfileEntry, 3> _handler;
+    uint64_t                        _timerTicks;
+    uint64_t                        _cycles;
+
+  public:
+    /// <summary>
+    /// Finds the names of the components of the given emulator.
+    /// </summary>
+    explicit HostProfiler(Emulator const& emulator);
+
+  public:
+    /// <summary>
+    /// Returns the entries of the given phase indexed as the indices of <c>OnHostTicks</c>.
+    /// </summary>
+    std::vector<HostProfileEntry> GetEntries(HostPhase phase) const;
+
+    /// <summary>
+    /// Returns the ticks subtracted from each sample.
+    /// </summary>
+    uint64_t GetTimerTicks() const noexcept
+    {
+        return _timerTicks;
+    }
+
+  public:
+    void OnHostTicks(HostPhase phase, size_t index, uint64_t ticks) noexcept;
+
+    void OnCycleEnd(Memory const&) noexcept
+    {
+        ++_cycles;
+    }
+
+  public:
+    /// <summary>
+    /// Prints the ticks of each component class in descending order. Components of the same
+    /// class are merged.
+    /// </summary>
+    void WriteReport(std::ostream& stream) const;
+};
+
+#endif
@@ -0,0 +1,35 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_HOST_TIMER_HH
+#define PIP_MIPS_EMU_HOST_TIMER_HH
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#    include <intrin.h>
+#    define PIP_MIPS_EMU_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#    define PIP_MIPS_EMU_HAS_RDTSC 1
+#else
+#    include <chrono>
+#endif
+
+/// <summary>
+/// Returns the time stamp counter of the host, which counts at a constant rate on recent x86
+/// processors regardless of the frequency of the core. Hosts without the counter return
+/// nanoseconds of <c>std::chrono::steady_clock</c> instead.
+/// </summary>
+inline uint64_t ReadHostTicks() noexcept
+{
+#if defined(PIP_MIPS_EMU_HAS_RDTSC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+#endif
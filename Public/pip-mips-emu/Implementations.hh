@@ -5,6 +5,7 @@
 #define PIP_MIPS_EMU_IMPLEMENTATIONS_HH
 
 #include <pip-mips-emu/Components.hh>
+#include <pip-mips-emu/MemoryLevel.hh>
 
 class DefaultHandler : public Handler
 {
@@ -40,6 +41,11 @@ enum class PipelineState : uint16_t
     Stalled  = 1,
     Flushed  = 2,
     Flushed3 = 3,
+
+    /// <summary>
+    /// Every stage keeps its state while a slow memory access is being served.
+    /// </summary>
+    MemoryStalled = 4,
 };
 
 class ATPPipelineStateController : public Controller
@@ -56,6 +62,9 @@ class ATPPipelineStateController : public Controller
     uint32_t ID_EX_MemRead;
     uint32_t ID_EX_Reg2;
 
+    uint32_t IF_StallCycles;
+    uint32_t MEM_StallCycles;
+
     // Signals
     uint32_t nextPCType;
     uint32_t pipelineState;
@@ -75,6 +84,9 @@ class ANTPPipelineStateController : public Controller
     uint32_t ID_EX_MemRead;
     uint32_t ID_EX_Reg2;
 
+    uint32_t IF_StallCycles;
+    uint32_t MEM_StallCycles;
+
     // Signals
     uint32_t nextPCType;
     uint32_t pipelineState;
@@ -84,15 +96,30 @@ class InstructionFetch : public Datapath
 {
     DATAPATH_DECLARE_FUNCTIONS()
 
+  private:
+    MemoryLevelPtr _memoryLevel;
+
+  public:
+    InstructionFetch() = default;
+
+    /// <summary>
+    /// Creates an instruction fetch stage whose fetches are timed by the given memory level, e.g.
+    /// an instruction cache.
+    /// </summary>
+    explicit InstructionFetch(MemoryLevelPtr memoryLevel);
+
   private:
     // Registers to read
     uint32_t PC;
+    uint32_t MEM_StallCycles;
 
     // Registers to write
     uint32_t IF_ID_PC;
     uint32_t IF_ID_NextPC;
     uint32_t IF_ID_Instr;
 
+    uint32_t IF_StallCycles;
+
     // Signals
     uint32_t nextPCType;
     uint32_t pipelineState;
@@ -197,6 +224,18 @@ class MemoryAccess : public Datapath
 {
     DATAPATH_DECLARE_FUNCTIONS()
 
+  private:
+    MemoryLevelPtr _memoryLevel;
+
+  public:
+    MemoryAccess() = default;
+
+    /// <summary>
+    /// Creates a memory access stage whose loads and stores are timed by the given memory level,
+    /// e.g. a data cache or a DRAM.
+    /// </summary>
+    explicit MemoryAccess(MemoryLevelPtr memoryLevel);
+
   private:
     // Registers to read
     uint32_t EX_MEM_PC;
@@ -216,6 +255,8 @@ class MemoryAccess : public Datapath
     uint32_t EX_MEM_RAWrite;
     uint32_t EX_MEM_RAValue;
 
+    uint32_t IF_StallCycles;
+
     // Registers to forward
     uint32_t MEM_WB_PC;
     uint32_t MEM_WB_Instr;
@@ -234,6 +275,8 @@ class MemoryAccess : public Datapath
 
     uint32_t PC;
 
+    uint32_t MEM_StallCycles;
+
     // Signals
     uint32_t nextPCType;
 };
@@ -264,6 +307,9 @@ class WriteBack : public Datapath
 
     // Registers to write
     uint32_t RA;
+
+    // Signals
+    uint32_t pipelineState;
 };
 
 #endif
\ No newline at end of file
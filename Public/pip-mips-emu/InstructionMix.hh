@@ -0,0 +1,116 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_INSTRUCTION_MIX_HH
+#define PIP_MIPS_EMU_INSTRUCTION_MIX_HH
+
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Formats.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+
+/// <summary>
+/// Counts the committed instructions by their operation and function fields, read from
+/// <c>WB_Instr</c> which <c>WriteBack</c> forwards at the commit point. The counts are kept in
+/// flat arrays indexed by the fields.
+/// </summary>
+class InstructionMix : public EmulatorObserver
+{
+  public:
+    static constexpr size_t NumOperations = 64, NumFunctions = 64;
+
+    /// <summary>
+    /// Number of the counters. Operations other than 0 use the counter of the operation, and
+    /// operation 0 uses the counter of the function after them.
+    /// </summary>
+    static constexpr size_t NumSlots = NumOperations + NumFunctions;
+
+  private:
+    Handler&                                    _handler;
+    uint32_t                                    _wbInstr;
+    std::array<uint64_t, NumSlots>              _counts;
+    std::array<uint64_t, NumSlots>              _takenBranches;
+    std::array<uint64_t, NumInstructionClasses> _classCounts;
+    uint64_t                                    _instructions;
+
+  public:
+    /// <summary>
+    /// Finds the registers of the given emulator. The emulator must outlive the counters.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the emulator does not have the
+    /// registers of the default pipeline.</exception>
+    explicit InstructionMix(Emulator const& emulator);
+
+  public:
+    static size_t GetSlot(uint32_t instruction) noexcept
+    {
+        uint32_t const operation = (instruction >> 26) & 0b111111;
+        uint32_t const function  = (instruction >> 0) & 0b111111;
+        return operation ? operation : NumOperations + function;
+    }
+
+    /// <summary>
+    /// Returns whether the given branch is taken when it commits. The operands are final then,
+    /// since all instructions before the branch have written back and none after it has.
+    /// </summary>
+    static bool IsBranchTaken(uint32_t instruction, Memory const& memory) noexcept
+    {
+        uint32_t const operation = (instruction >> 26) & 0b111111;
+        bool const     equal     = memory.GetRegister((instruction >> 21) & 0b11111)
+                           == memory.GetRegister((instruction >> 16) & 0b11111);
+        return equal == (operation == static_cast<uint32_t>(BIFormatOp::BEQ));
+    }
+
+    uint64_t GetInstructions() const noexcept
+    {
+        return _instructions;
+    }
+
+    /// <summary>
+    /// Returns the number of the committed instructions of the given operation or function of
+    /// <c>Formats.hh</c>, such as <c>RFormatFn::ADDU</c> or <c>OIFormatOp::LW</c>.
+    /// </summary>
+    template <typename Code>
+    uint64_t GetCount(Code code) const noexcept
+    {
+        constexpr bool isFunction = std::is_same_v<Code, RFormatFn>
+                                    || std::is_same_v<Code, JRFormatFn>
+                                    || std::is_same_v<Code, SRFormatFn>;
+
+        size_t const value = static_cast<size_t>(code);
+        return _counts[isFunction ? NumOperations + value : value];
+    }
+
+    uint64_t GetCount(InstructionClass instructionClass) const noexcept
+    {
+        return _classCounts[static_cast<size_t>(instructionClass)];
+    }
+
+    /// <summary>
+    /// Returns the number of the committed branches of the given operation which are taken.
+    /// </summary>
+    uint64_t GetTakenBranches(BIFormatOp operation) const noexcept
+    {
+        return _takenBranches[static_cast<size_t>(operation)];
+    }
+
+  public:
+    /// <summary>
+    /// Counts the instruction committed in this cycle.
+    /// </summary>
+    void OnCycleEnd(Memory const& memory) noexcept;
+
+  public:
+    /// <summary>
+    /// Prints the counts of each instruction and class and the ratios of taken branches.
+    /// </summary>
+    void WriteReport(std::ostream& stream) const;
+};
+
+#endif
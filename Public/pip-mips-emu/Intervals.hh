@@ -0,0 +1,158 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_INTERVALS_HH
+#define PIP_MIPS_EMU_INTERVALS_HH
+
+#include <pip-mips-emu/AsyncWriter.hh>
+#include <pip-mips-emu/Counters.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Magic number at the beginning of binary interval statistics
+/// </summary>
+constexpr char IntervalFileMagic[4] { '\x7F', 'P', 'M', 'I' };
+
+/// <summary>
+/// Version of the binary format written by <c>IntervalWriter</c>
+/// </summary>
+constexpr uint32_t IntervalFileVersion = 1;
+
+/// <summary>
+/// Size of the header of binary interval statistics. The header consists of the magic number
+/// followed by the version, the interval in cycles and the number of columns, each of which is a
+/// little endian word. Blocks follow the header. A block consists of the number of its rows
+/// followed by the values of each column of the rows in the order of <c>IntervalColumn</c>, each
+/// of which is a little endian word.
+/// </summary>
+constexpr size_t IntervalFileHeaderSize = 16;
+
+/// <summary>
+/// Columns of a row of the interval statistics. Except <c>Cycle</c>, the values are counted in
+/// the interval only.
+/// </summary>
+enum class IntervalColumn : uint32_t
+{
+    /// <summary>
+    /// The last cycle of the interval
+    /// </summary>
+    Cycle,
+
+    /// <summary>
+    /// Length of the interval, which is shorter than the configured one only for the last row
+    /// </summary>
+    Cycles,
+
+    Instructions,
+    LoadUseStalls,
+    MemoryStalls,
+    FlushCycles,
+
+    /// <summary>
+    /// Committed branches
+    /// </summary>
+    Branches,
+
+    /// <summary>
+    /// Committed branches whose conditions hold
+    /// </summary>
+    TakenBranches,
+
+    Mispredictions,
+
+    /// <summary>
+    /// Committed loads
+    /// </summary>
+    Loads,
+
+    /// <summary>
+    /// Committed stores
+    /// </summary>
+    Stores,
+};
+
+constexpr size_t NumIntervalColumns = static_cast<size_t>(IntervalColumn::Stores) + 1;
+
+using IntervalRow = std::array<uint32_t, NumIntervalColumns>;
+
+/// <summary>
+/// Returns the name of the given column used in the header of CSV files, such as
+/// <c>loadUseStalls</c>.
+/// </summary>
+char const* GetColumnName(IntervalColumn column) noexcept;
+
+/// <summary>
+/// Writes a row of statistics every given number of cycles, so that the phases of a program can
+/// be plotted. The rows are buffered in blocks and queued to <c>AsyncWriter</c>s, in the columnar
+/// binary format and as CSV.
+/// </summary>
+class IntervalWriter : public EmulatorObserver
+{
+  public:
+    /// <summary>
+    /// Number of the rows of a block of the binary format
+    /// </summary>
+    static constexpr size_t BlockRows = 256;
+
+  private:
+    Handler&         _handler;
+    CounterCollector _collector;
+    uint32_t         _wbInstr;
+    uint32_t         _interval;
+    AsyncWriter*     _binary;
+    AsyncWriter*     _csv;
+
+    // The counters at the beginning of the current interval and the values of the columns which
+    // are not kept by the collector
+    PipelineCounters _last;
+    IntervalRow      _row;
+
+    // The rows of the current block by columns
+    std::array<std::vector<uint32_t>, NumIntervalColumns> _columns;
+    std::vector<char>                                     _csvBuffer;
+
+  public:
+    /// <summary>
+    /// Queues the headers to the given writers, either of which may be <c>nullptr</c>. The
+    /// emulator and the writers must outlive this writer.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the interval is 0, or when the
+    /// emulator does not have the signals and the registers of the default pipeline.</exception>
+    IntervalWriter(Emulator const& emulator,
+                   uint32_t        interval,
+                   AsyncWriter*    binary,
+                   AsyncWriter*    csv);
+
+  public:
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls)
+    {
+        _collector.OnControlsResolved(memory, controls);
+    }
+
+    void OnCycleEnd(Memory const& memory);
+
+  public:
+    /// <summary>
+    /// Ends the current interval if it has any cycle, and queues the buffered rows.
+    /// </summary>
+    void Flush();
+
+  private:
+    void EndInterval();
+};
+
+/// <summary>
+/// Reads the rows of the given binary interval statistics, and stores the interval of the file
+/// to <c>interval</c> unless it is <c>nullptr</c>.
+/// </summary>
+/// <exception cref="std::runtime_error">Thrown when the file is invalid.</exception>
+std::vector<IntervalRow> DecodeIntervals(std::istream& is, uint32_t* interval = nullptr);
+
+#endif
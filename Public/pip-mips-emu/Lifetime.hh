@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_LIFETIME_HH
+#define PIP_MIPS_EMU_LIFETIME_HH
+
+#include <pip-mips-emu/Counters.hh>
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Latencies of the committed instructions of an <c>InstructionClass</c>
+/// </summary>
+struct LifetimeStats
+{
+    /// <summary>
+    /// Latencies of this value or more are counted in the last bucket of the histogram.
+    /// </summary>
+    static constexpr size_t NumBuckets = 32;
+
+    /// <summary>
+    /// Number of the latches an instruction passes through before it commits, from IF/ID to
+    /// MEM/WB
+    /// </summary>
+    static constexpr size_t NumLatches = Handler::NumStages - 1;
+
+    uint64_t count = 0, latencySum = 0, maxLatency = 0;
+
+    /// <summary>
+    /// Sums of the cycles spent in each latch from IF/ID to MEM/WB
+    /// </summary>
+    std::array<uint64_t, NumLatches> latchCycles {};
+
+    /// <summary>
+    /// Numbers of the instructions by their fetch-to-commit latency
+    /// </summary>
+    std::array<uint64_t, NumBuckets> histogram {};
+
+    double GetAverageLatency() const noexcept
+    {
+        return count ? static_cast<double>(latencySum) / count : 0.0;
+    }
+};
+
+/// <summary>
+/// Follows each fetched instruction from IF/ID to WB by the sequence numbers of
+/// <c>PipelineTracker</c>, recording the cycle it enters each latch. The instructions in flight
+/// are kept in a fixed-size table indexed by their sequence numbers, so tracking does not
+/// allocate. The latency of an instruction is the number of cycles from the cycle fetching it to
+/// the cycle committing it, which is 5 without stalls.
+/// </summary>
+class LifetimeTracker : public EmulatorObserver
+{
+  private:
+    /// <summary>
+    /// More than the instructions which can be in flight at once, including the ones discarded by
+    /// a misprediction
+    /// </summary>
+    static constexpr size_t TableSize = 16;
+
+    struct InFlight
+    {
+        uint64_t         sequence;
+        InstructionClass instructionClass;
+
+        /// <summary>
+        /// Cycles entering IF/ID, ID/EX, EX/MEM, MEM/WB and WB. 0 if not entered yet.
+        /// </summary>
+        std::array<uint64_t, Handler::NumStages> cycles;
+    };
+
+    Handler&                                         _handler;
+    PipelineTracker                                  _tracker;
+    std::array<InFlight, TableSize>                  _table;
+    std::array<LifetimeStats, NumInstructionClasses> _stats;
+    uint64_t                                         _cycles;
+
+  public:
+    /// <summary>
+    /// Finds the signals and the registers of the given emulator. The emulator must outlive the
+    /// tracker.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the emulator does not have the
+    /// signals and the registers of the default pipeline.</exception>
+    explicit LifetimeTracker(Emulator const& emulator);
+
+  public:
+    LifetimeStats const& GetStats(InstructionClass instructionClass) const noexcept
+    {
+        return _stats[static_cast<size_t>(instructionClass)];
+    }
+
+    /// <summary>
+    /// Returns the sum of the statistics of all classes.
+    /// </summary>
+    LifetimeStats GetTotalStats() const noexcept;
+
+  public:
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls)
+    {
+        _tracker.Resolve(memory, controls);
+    }
+
+    void OnCycleEnd(Memory const& memory) noexcept;
+
+  public:
+    /// <summary>
+    /// Prints the latencies of each class and the latency histograms.
+    /// </summary>
+    void WriteReport(std::ostream& stream) const;
+};
+
+#endif
@@ -63,6 +63,12 @@ struct Address
     }
 };
 
+/// <summary>
+/// Addresses of the first bytes of the segments
+/// </summary>
+constexpr uint32_t TextBase = static_cast<uint32_t>(Address::BaseType::Text);
+constexpr uint32_t DataBase = static_cast<uint32_t>(Address::BaseType::Data);
+
 /// <summary>
 /// Represents a range in the memory. Note that <c>end</c> is inclusive.
 /// </summary>
@@ -72,6 +78,76 @@ struct Range
     Address end;
 };
 
+/// <summary>
+/// Read-only view of contiguous bytes in a segment. A view is invalidated when the segment is
+/// mutated.
+/// </summary>
+class MemoryView
+{
+  private:
+    uint8_t const* _data;
+    size_t         _size;
+
+  public:
+    constexpr MemoryView() noexcept : _data { nullptr }, _size { 0 } {}
+
+    constexpr MemoryView(uint8_t const* data, size_t size) noexcept : _data { data }, _size { size }
+    {}
+
+  public:
+    constexpr uint8_t const* data() const noexcept
+    {
+        return _data;
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    constexpr uint8_t const* begin() const noexcept
+    {
+        return _data;
+    }
+
+    constexpr uint8_t const* end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    constexpr uint8_t operator[](size_t idx) const noexcept
+    {
+        return _data[idx];
+    }
+};
+
+/// <summary>
+/// Differences between two <c>Memory</c> objects.
+/// </summary>
+struct MemoryDiff
+{
+    /// <summary>
+    /// Indices of the registers whose values differ, in ascending order
+    /// </summary>
+    std::vector<uint32_t> registers;
+
+    /// <summary>
+    /// Maximal runs of differing bytes in ascending order. Bytes which exist in only one of the
+    /// objects are considered to differ.
+    /// </summary>
+    std::vector<Range> ranges;
+
+    bool IsEmpty() const noexcept
+    {
+        return registers.empty() && ranges.empty();
+    }
+};
+
 /// <summary>
 /// Represents a state of the device at the specific time point.
 /// </summary>
@@ -152,6 +228,54 @@ class Memory
     /// endian format.
     /// </summary>
     void SetWord(Address address, uint32_t word);
+
+    /// <summary>
+    /// Copies bytes starting at the given address. Bytes outside the segment are read as zero.
+    /// </summary>
+    /// <param name="address">The address of the first byte</param>
+    /// <param name="out">The buffer to write bytes to</param>
+    /// <param name="size">The number of bytes to read</param>
+    void ReadBytes(Address address, uint8_t* out, size_t size) const noexcept;
+
+    /// <summary>
+    /// Copies the given bytes to the memory starting at the given address.
+    /// </summary>
+    /// <exception cref="std::out_of_range">Thrown when the bytes do not fit in the
+    /// segment.</exception>
+    void WriteBytes(Address address, uint8_t const* bytes, size_t size);
+
+    /// <summary>
+    /// Reads consecutive big endian words starting at the given address. Bytes outside the segment
+    /// are read as zero.
+    /// </summary>
+    /// <param name="address">The address of the first word</param>
+    /// <param name="out">The buffer to write words to</param>
+    /// <param name="count">The number of words to read</param>
+    void ReadWords(Address address, uint32_t* out, size_t count) const noexcept;
+
+    /// <summary>
+    /// Returns a read-only view of the bytes starting at the given address.
+    /// </summary>
+    /// <exception cref="std::out_of_range">Thrown when the range does not fit in the
+    /// segment.</exception>
+    MemoryView View(Address address, size_t size) const;
+
+    /// <summary>
+    /// Returns a read-only view of the whole segment.
+    /// </summary>
+    MemoryView View(Address::BaseType base) const;
+
+    /// <summary>
+    /// Returns a 64-bit hash of the registers and both segments. Objects which compare equal with
+    /// <c>Diff</c> have the same hash.
+    /// </summary>
+    uint64_t Hash() const noexcept;
+
+  public:
+    /// <summary>
+    /// Compares the registers and the segments of the given objects.
+    /// </summary>
+    static MemoryDiff Diff(Memory const& lhs, Memory const& rhs);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_MEMORY_LEVEL_HH
+#define PIP_MIPS_EMU_MEMORY_LEVEL_HH
+
+#include <cstdint>
+#include <memory>
+
+/// <summary>
+/// Identifies the kind of a memory access.
+/// </summary>
+enum class AccessType : uint8_t
+{
+    Read,
+    Write,
+};
+
+/// <summary>
+/// Identifies the stage and the direction of a memory access of the pipeline.
+/// </summary>
+enum class AccessKind : uint8_t
+{
+    Fetch,
+    Load,
+    Store,
+};
+
+/// <summary>
+/// Memory access made by a pipeline stage, reported to observers by
+/// <c>EmulatorObserver::OnMemoryAccess</c>
+/// </summary>
+struct StageAccess
+{
+    AccessKind kind;
+
+    /// <summary>
+    /// PC of the accessing instruction, which is the address for fetches
+    /// </summary>
+    uint32_t pc;
+
+    uint32_t address;
+
+    /// <summary>
+    /// Size of the access in bytes
+    /// </summary>
+    uint32_t size;
+};
+
+/// <summary>
+/// Represents a timing model of a level in the memory hierarchy. Implementers only compute
+/// latencies; the contents always live in <c>Memory</c>, so a timing model never changes the
+/// result of a program.
+/// </summary>
+class MemoryLevel
+{
+  public:
+    virtual ~MemoryLevel() = default;
+
+  public:
+    /// <summary>
+    /// Simulates an access and updates the internal state of the model.
+    /// </summary>
+    /// <param name="address">The accessed address</param>
+    /// <param name="type">Whether the access is a load or a store</param>
+    /// <returns>The number of cycles the pipeline must stall</returns>
+    virtual uint32_t Access(uint32_t address, AccessType type) noexcept = 0;
+
+    /// <summary>
+    /// Advances the model by one cycle. <c>MemoryAccess</c> calls this function once per cycle,
+    /// including the cycles in which the pipeline is stalled.
+    /// </summary>
+    virtual void Tick() noexcept {}
+};
+
+using MemoryLevelPtr = std::shared_ptr<MemoryLevel>;
+
+#endif
@@ -0,0 +1,350 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_OBSERVER_HH
+#define PIP_MIPS_EMU_OBSERVER_HH
+
+#include <pip-mips-emu/Components.hh>
+#include <pip-mips-emu/Memory.hh>
+#include <pip-mips-emu/MemoryLevel.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// Identifies the part of <c>Emulator::TickTock</c> measured by <c>OnHostTicks</c>.
+/// </summary>
+enum class HostPhase : uint8_t
+{
+    /// <summary>
+    /// <c>Controller::Execute</c>. The index is the index of the controller.
+    /// </summary>
+    Controller,
+
+    /// <summary>
+    /// <c>Datapath::Execute</c>. The index is the index of the datapath in the order
+    /// <c>Emulator::GetDatapathNames</c> returns.
+    /// </summary>
+    Datapath,
+
+    /// <summary>
+    /// Applying the deltas of the datapaths run before the signals are final (index 0) or after
+    /// them (index 1)
+    /// </summary>
+    ApplyDeltas,
+
+    /// <summary>
+    /// <c>Handler::IsTerminated</c> (index 0), <c>Handler::CalcNumInstructions</c> (index 1) or
+    /// <c>Handler::GetPCs</c> (index 2)
+    /// </summary>
+    Handler,
+};
+
+/// <summary>
+/// Receives the events of <c>Emulator::TickTock</c>. Implementers derive from this class and
+/// hide the functions of the events they are interested in; the others do nothing. The functions
+/// are resolved at compile time, and <c>TickTock</c> with this class itself compiles to the same
+/// code as without an observer.
+/// </summary>
+class EmulatorObserver
+{
+  public:
+    /// <summary>
+    /// Called at the beginning of each cycle.
+    /// </summary>
+    void OnCycleBegin(Memory const&) {}
+
+    /// <summary>
+    /// Called after the controllers have set the control signals of the cycle. The values are
+    /// indexed by the signal indices.
+    /// </summary>
+    void OnControlsResolved(Memory const&, std::vector<uint16_t> const&) {}
+
+    /// <summary>
+    /// Called after each delta is applied. Conditioned deltas whose conditions do not hold are not
+    /// reported.
+    /// </summary>
+    void OnDeltaApplied(Memory const&, Delta const&) {}
+
+    /// <summary>
+    /// Called for each instruction fetch, load and store made by the datapaths in the cycle, in
+    /// the order they are made, after the deltas of the cycle are applied.
+    /// </summary>
+    void OnMemoryAccess(StageAccess const&) {}
+
+    /// <summary>
+    /// Called when an instruction leaves the write back stage, with the PC of the instruction.
+    /// </summary>
+    void OnInstructionCommitted(Memory const&, uint32_t) {}
+
+    /// <summary>
+    /// Called at the end of each cycle which succeeded.
+    /// </summary>
+    void OnCycleEnd(Memory const&) {}
+
+    /// <summary>
+    /// Called after each measured part of the cycle with the elapsed ticks of
+    /// <c>ReadHostTicks</c>. The host time is measured only for the observers handling this event.
+    /// </summary>
+    void OnHostTicks(HostPhase, size_t, uint64_t) {}
+};
+
+/// <summary>
+/// <c>true</c> if the given observer ignores all events
+/// </summary>
+template <typename Observer>
+constexpr bool IsNullObserver = std::is_same_v<Observer, EmulatorObserver>;
+
+/// <summary>
+/// Forwards the events to each of the given observers in order.
+/// </summary>
+template <typename... Observers>
+class CompositeObserver : public EmulatorObserver
+{
+  private:
+    std::tuple<Observers&...> _observers;
+
+  public:
+    explicit CompositeObserver(Observers&... observers) : _observers { observers... } {}
+
+  public:
+    void OnCycleBegin(Memory const& memory)
+    {
+        ForEach([&](auto& observer) { observer.OnCycleBegin(memory); });
+    }
+
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls)
+    {
+        ForEach([&](auto& observer) { observer.OnControlsResolved(memory, controls); });
+    }
+
+    void OnDeltaApplied(Memory const& memory, Delta const& delta)
+    {
+        ForEach([&](auto& observer) { observer.OnDeltaApplied(memory, delta); });
+    }
+
+    void OnMemoryAccess(StageAccess const& access)
+    {
+        ForEach([&](auto& observer) { observer.OnMemoryAccess(access); });
+    }
+
+    void OnInstructionCommitted(Memory const& memory, uint32_t pc)
+    {
+        ForEach([&](auto& observer) { observer.OnInstructionCommitted(memory, pc); });
+    }
+
+    void OnCycleEnd(Memory const& memory)
+    {
+        ForEach([&](auto& observer) { observer.OnCycleEnd(memory); });
+    }
+
+    void OnHostTicks(HostPhase phase, size_t index, uint64_t ticks)
+    {
+        ForEach([&](auto& observer) { observer.OnHostTicks(phase, index, ticks); });
+    }
+
+  private:
+    template <typename Function>
+    void ForEach(Function&& function)
+    {
+        std::apply([&](auto&... observers) { (function(observers), ...); }, _observers);
+    }
+};
+
+/// <summary>
+/// Forwards the events to the given observer if it is not <c>nullptr</c>. Used with
+/// <c>CompositeObserver</c> to combine observers enabled at runtime.
+/// </summary>
+template <typename Observer>
+class OptionalObserver : public EmulatorObserver
+{
+  private:
+    Observer* _observer;
+
+  public:
+    explicit OptionalObserver(Observer* observer) noexcept : _observer { observer } {}
+
+  public:
+    void OnCycleBegin(Memory const& memory)
+    {
+        if (_observer)
+            _observer->OnCycleBegin(memory);
+    }
+
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls)
+    {
+        if (_observer)
+            _observer->OnControlsResolved(memory, controls);
+    }
+
+    void OnDeltaApplied(Memory const& memory, Delta const& delta)
+    {
+        if (_observer)
+            _observer->OnDeltaApplied(memory, delta);
+    }
+
+    void OnMemoryAccess(StageAccess const& access)
+    {
+        if (_observer)
+            _observer->OnMemoryAccess(access);
+    }
+
+    void OnInstructionCommitted(Memory const& memory, uint32_t pc)
+    {
+        if (_observer)
+            _observer->OnInstructionCommitted(memory, pc);
+    }
+
+    void OnCycleEnd(Memory const& memory)
+    {
+        if (_observer)
+            _observer->OnCycleEnd(memory);
+    }
+
+    void OnHostTicks(HostPhase phase, size_t index, uint64_t ticks)
+    {
+        if (_observer)
+            _observer->OnHostTicks(phase, index, ticks);
+    }
+};
+
+/// <summary>
+/// <c>true</c> if the given observer hides the function of <c>EmulatorObserver</c> of the given
+/// event
+/// </summary>
+#define OBSERVER_HANDLES(Observer, Event)                                                          \
+    (!std::is_same_v<decltype(&Observer::Event), decltype(&EmulatorObserver::Event)>)
+
+/// <summary>
+/// <c>true</c> if the given observer handles <c>OnDeltaApplied</c>. The event is reported for
+/// each delta, so it is not generated for the other observers.
+/// </summary>
+template <typename Observer>
+struct ObservesDeltas : std::bool_constant<OBSERVER_HANDLES(Observer, OnDeltaApplied)>
+{};
+
+template <typename... Observers>
+struct ObservesDeltas<CompositeObserver<Observers...>>
+    : std::disjunction<ObservesDeltas<Observers>...>
+{};
+
+template <typename Observer>
+struct ObservesDeltas<OptionalObserver<Observer>> : ObservesDeltas<Observer>
+{};
+
+/// <summary>
+/// <c>true</c> if the given observer handles <c>OnMemoryAccess</c>. The datapaths log their
+/// accesses only for these observers, so the other ones pay nothing for the event.
+/// </summary>
+template <typename Observer>
+struct ObservesMemoryAccesses : std::bool_constant<OBSERVER_HANDLES(Observer, OnMemoryAccess)>
+{};
+
+template <typename... Observers>
+struct ObservesMemoryAccesses<CompositeObserver<Observers...>>
+    : std::disjunction<ObservesMemoryAccesses<Observers>...>
+{};
+
+template <typename Observer>
+struct ObservesMemoryAccesses<OptionalObserver<Observer>> : ObservesMemoryAccesses<Observer>
+{};
+
+/// <summary>
+/// <c>true</c> if the given observer handles <c>OnInstructionCommitted</c>. Finding the PC of the
+/// committed instruction asks the handler, so it is skipped for the other observers.
+/// </summary>
+template <typename Observer>
+struct ObservesCommits : std::bool_constant<OBSERVER_HANDLES(Observer, OnInstructionCommitted)>
+{};
+
+template <typename... Observers>
+struct ObservesCommits<CompositeObserver<Observers...>>
+    : std::disjunction<ObservesCommits<Observers>...>
+{};
+
+template <typename Observer>
+struct ObservesCommits<OptionalObserver<Observer>> : ObservesCommits<Observer>
+{};
+
+/// <summary>
+/// <c>true</c> if the given observer handles <c>OnHostTicks</c>. Reading the timer costs a few
+/// dozen host cycles, so it is skipped for the other observers.
+/// </summary>
+template <typename Observer>
+struct ObservesHostTicks : std::bool_constant<OBSERVER_HANDLES(Observer, OnHostTicks)>
+{};
+
+template <typename... Observers>
+struct ObservesHostTicks<CompositeObserver<Observers...>>
+    : std::disjunction<ObservesHostTicks<Observers>...>
+{};
+
+template <typename Observer>
+struct ObservesHostTicks<OptionalObserver<Observer>> : ObservesHostTicks<Observer>
+{};
+
+/// <summary>
+/// Locations written by the deltas applied in a cycle. A location may appear more than once, and
+/// its value may be the same as before.
+/// </summary>
+struct AppliedWrites
+{
+    /// <summary>
+    /// Indices of the written registers among r0 - r31 and PC
+    /// </summary>
+    std::vector<uint32_t> registers;
+
+    /// <summary>
+    /// Addresses of the written words. Stores of bytes are recorded as their words.
+    /// </summary>
+    std::vector<uint32_t> addresses;
+
+    void Clear() noexcept
+    {
+        registers.clear();
+        addresses.clear();
+    }
+};
+
+/// <summary>
+/// Records the locations written by the last cycle.
+/// </summary>
+class WriteRecorder : public EmulatorObserver
+{
+  private:
+    AppliedWrites _writes;
+
+  public:
+    AppliedWrites const& GetWrites() const noexcept
+    {
+        return _writes;
+    }
+
+  public:
+    void OnCycleBegin(Memory const&)
+    {
+        _writes.Clear();
+    }
+
+    void OnDeltaApplied(Memory const&, Delta const& delta)
+    {
+        switch (delta.type)
+        {
+        case Delta::Type::Register:
+        case Delta::Type::Conditioned:
+        case Delta::Type::Unless:
+            if (delta.target <= Memory::PC)
+                _writes.registers.push_back(delta.target);
+            break;
+        case Delta::Type::MemoryWord: _writes.addresses.push_back(delta.target); break;
+        case Delta::Type::MemoryByte:
+            _writes.addresses.push_back(delta.target & ~static_cast<uint32_t>(3));
+            break;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_PERF_COUNTERS_HH
+#define PIP_MIPS_EMU_PERF_COUNTERS_HH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+
+/// <summary>
+/// Hardware events counted by <c>PerfCounters</c>
+/// </summary>
+enum class PerfEvent : uint8_t
+{
+    Cycles,
+    Instructions,
+    CacheMisses,
+    BranchMisses,
+};
+
+constexpr size_t NumPerfEvents = static_cast<size_t>(PerfEvent::BranchMisses) + 1;
+
+/// <summary>
+/// Counts hardware events of the calling thread with <c>perf_event_open</c>, excluding the
+/// kernel. Events which cannot be opened, for example because of
+/// <c>/proc/sys/kernel/perf_event_paranoid</c> or on hosts other than Linux, are skipped.
+/// </summary>
+class PerfCounters
+{
+  private:
+    std::array<int, NumPerfEvents> _fds;
+
+  public:
+    /// <summary>
+    /// Opens the counters without starting them.
+    /// </summary>
+    PerfCounters() noexcept;
+
+    PerfCounters(PerfCounters const&) = delete;
+    PerfCounters& operator=(PerfCounters const&) = delete;
+
+    ~PerfCounters();
+
+  public:
+    bool IsAvailable(PerfEvent event) const noexcept
+    {
+        return _fds[static_cast<size_t>(event)] >= 0;
+    }
+
+    bool IsAnyAvailable() const noexcept;
+
+  public:
+    /// <summary>
+    /// Resets and starts the available counters.
+    /// </summary>
+    void Start() noexcept;
+
+    /// <summary>
+    /// Stops the available counters.
+    /// </summary>
+    void Stop() noexcept;
+
+    /// <summary>
+    /// Returns the count of the given event, scaled up if the kernel multiplexed the counter, or
+    /// <c>std::nullopt</c> if it is not available.
+    /// </summary>
+    std::optional<uint64_t> Read(PerfEvent event) const noexcept;
+};
+
+/// <summary>
+/// Prints the available counts with the host instructions per emulated cycle and the host IPC.
+/// </summary>
+void WritePerfReport(PerfCounters const& counters,
+                     uint64_t            emulatedCycles,
+                     uint64_t            emulatedInstructions,
+                     std::ostream&       stream);
+
+#endif
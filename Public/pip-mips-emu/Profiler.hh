@@ -0,0 +1,108 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_PROFILER_HH
+#define PIP_MIPS_EMU_PROFILER_HH
+
+#include <pip-mips-emu/Counters.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/// <summary>
+/// Cycles attributed to an instruction of the text segment
+/// </summary>
+struct ProfileEntry
+{
+    /// <summary>
+    /// Cycles which committed the instruction
+    /// </summary>
+    uint64_t commits = 0;
+
+    /// <summary>
+    /// Cycles lost by load-use stalls of the instruction and by memory stalls of its accesses
+    /// </summary>
+    uint64_t stallCycles = 0;
+
+    /// <summary>
+    /// Cycles lost by flushes caused by the instruction
+    /// </summary>
+    uint64_t flushCycles = 0;
+
+    uint64_t GetCycles() const noexcept
+    {
+        return commits + stallCycles + flushCycles;
+    }
+};
+
+/// <summary>
+/// Attributes each cycle to the static instruction which committed in it or which caused the
+/// bubble in WB, as <c>CounterCollector</c> attributes them to causes. Cycles without such an
+/// instruction, such as filling and draining the pipeline, are counted separately.
+/// </summary>
+class Profiler : public EmulatorObserver
+{
+  private:
+    Handler&                  _handler;
+    PipelineTracker           _tracker;
+    uint32_t                  _wbPC;
+    std::vector<ProfileEntry> _entries;
+    uint64_t                  _cycles, _unattributedCycles;
+
+  public:
+    /// <summary>
+    /// Creates an entry for each word of the text segment of the given memory. The emulator must
+    /// outlive the profiler.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the emulator does not have the
+    /// signals and the registers of the default pipeline.</exception>
+    Profiler(Emulator const& emulator, Memory const& memory);
+
+  public:
+    /// <summary>
+    /// Returns the entries indexed by <c>(PC - text base) / 4</c>.
+    /// </summary>
+    std::vector<ProfileEntry> const& GetEntries() const noexcept
+    {
+        return _entries;
+    }
+
+    uint64_t GetCycles() const noexcept
+    {
+        return _cycles;
+    }
+
+    uint64_t GetUnattributedCycles() const noexcept
+    {
+        return _unattributedCycles;
+    }
+
+  public:
+    void OnControlsResolved(Memory const& memory, std::vector<uint16_t> const& controls)
+    {
+        _tracker.Resolve(memory, controls);
+    }
+
+    void OnCycleEnd(Memory const& memory) noexcept;
+
+  public:
+    /// <summary>
+    /// Prints the instructions with any cycle in descending order of their cycles.
+    /// </summary>
+    /// <param name="memory">The memory whose text segment is disassembled</param>
+    void WriteFlatProfile(Memory const& memory, std::ostream& stream) const;
+
+    /// <summary>
+    /// Prints all instructions of the text segment in address order with their cycles.
+    /// </summary>
+    /// <param name="memory">The memory whose text segment is disassembled</param>
+    void WriteAnnotatedListing(Memory const& memory, std::ostream& stream) const;
+
+  private:
+    ProfileEntry* Find(uint32_t pc) noexcept;
+};
+
+#endif
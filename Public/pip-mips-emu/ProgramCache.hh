@@ -0,0 +1,93 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_PROGRAM_CACHE_HH
+#define PIP_MIPS_EMU_PROGRAM_CACHE_HH
+
+#include <pip-mips-emu/File.hh>
+
+#include <cstdint>
+#include <filesystem>
+
+/// <summary>
+/// Describes where and how much a <c>ProgramCache</c> stores.
+/// </summary>
+struct ProgramCacheConfig
+{
+    /// <summary>
+    /// Directory containing the cached images. Created if it does not exist.
+    /// </summary>
+    std::filesystem::path directory;
+
+    /// <summary>
+    /// Upper bound of the total size of the cached images in bytes. The least recently used images
+    /// are removed when the bound is exceeded.
+    /// </summary>
+    uint64_t maxSize = uint64_t { 1 } << 30;
+};
+
+/// <summary>
+/// Hit and miss counters of a <c>ProgramCache</c>.
+/// </summary>
+struct ProgramCacheStats
+{
+    uint64_t hits   = 0;
+    uint64_t misses = 0;
+
+    /// <summary>
+    /// Images written to the cache
+    /// </summary>
+    uint64_t stores = 0;
+
+    /// <summary>
+    /// Images removed to keep the total size under the bound
+    /// </summary>
+    uint64_t evictions = 0;
+};
+
+/// <summary>
+/// On-disk cache of parsed text executables. Images are stored in the binary executable format
+/// under the content hash of the source file, so a cached image is mapped instead of the source
+/// being parsed again. Multiple processes may share a directory: images are written to temporary
+/// files and renamed into place. Failures of the cache itself are never reported; the source is
+/// read directly instead.
+/// </summary>
+class ProgramCache
+{
+  private:
+    ProgramCacheConfig _config;
+    ProgramCacheStats  _stats;
+
+  public:
+    explicit ProgramCache(ProgramCacheConfig config);
+
+  public:
+    ProgramCacheConfig const& GetConfig() const noexcept
+    {
+        return _config;
+    }
+
+    ProgramCacheStats const& GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+  public:
+    /// <summary>
+    /// Reads an executable from the given path, using the cached image if it exists. Binary and
+    /// ELF executables are read directly since they are not parsed.
+    /// </summary>
+    FileReadResult Read(std::filesystem::path const& path);
+
+    /// <summary>
+    /// Returns the default cache directory, or an empty path if it cannot be determined.
+    /// </summary>
+    static std::filesystem::path GetDefaultDirectory();
+
+  private:
+    void Store(std::filesystem::path const& imagePath, CanRead const& file);
+
+    void Trim();
+};
+
+#endif
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_RING_BUFFER_HH
+#define PIP_MIPS_EMU_RING_BUFFER_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// <summary>
+/// Lock-free ring buffer with a single producer thread and a single consumer thread.
+/// </summary>
+template <typename T>
+class SpscRingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+  private:
+    // Keeps the indices modified by different threads in different cache lines
+    constexpr static size_t CacheLineSize = 64;
+
+  private:
+    std::unique_ptr<T[]> _items;
+    size_t               _capacity;
+
+    // Modified by the consumer
+    alignas(CacheLineSize) std::atomic<size_t> _head;
+
+    // Modified by the producer
+    alignas(CacheLineSize) std::atomic<size_t> _tail;
+
+    // The last head seen by the producer, which avoids reading the head on every push
+    alignas(CacheLineSize) size_t _cachedHead;
+
+  public:
+    /// <summary>
+    /// Creates an empty ring buffer.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the capacity is not a power of
+    /// two.</exception>
+    explicit SpscRingBuffer(size_t capacity) :
+        _items { std::make_unique<T[]>(capacity) },
+        _capacity { capacity },
+        _head { 0 },
+        _tail { 0 },
+        _cachedHead { 0 }
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument { "capacity of a ring buffer must be a power of two" };
+    }
+
+    SpscRingBuffer(SpscRingBuffer const&) = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer const&) = delete;
+
+  public:
+    size_t GetCapacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    /// <summary>
+    /// Appends all of the given items, or none of them if there is not enough space. Must be
+    /// called by the producer only.
+    /// </summary>
+    bool TryPush(T const* items, size_t count) noexcept
+    {
+        size_t const tail = _tail.load(std::memory_order_relaxed);
+        if (_capacity - (tail - _cachedHead) < count)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (_capacity - (tail - _cachedHead) < count)
+                return false;
+        }
+
+        size_t const offset     = tail & (_capacity - 1);
+        size_t const firstCount = std::min(count, _capacity - offset);
+        std::copy_n(items, firstCount, _items.get() + offset);
+        std::copy_n(items + firstCount, count - firstCount, _items.get());
+
+        _tail.store(tail + count, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Returns the longest contiguous sequence of the oldest items. The items stay in the buffer
+    /// until <c>Pop</c> is called. Must be called by the consumer only.
+    /// </summary>
+    std::pair<T const*, size_t> Peek() noexcept
+    {
+        size_t const head = _head.load(std::memory_order_relaxed);
+        size_t const tail = _tail.load(std::memory_order_acquire);
+
+        size_t const offset = head & (_capacity - 1);
+        size_t const count  = std::min(tail - head, _capacity - offset);
+        return std::make_pair(_items.get() + offset, count);
+    }
+
+    /// <summary>
+    /// Removes the given number of the oldest items, which must not be more than the items returned
+    /// by the last call to <c>Peek</c>. Must be called by the consumer only.
+    /// </summary>
+    void Pop(size_t count) noexcept
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// Returns <c>true</c> if there is no item. May be called by any thread.
+    /// </summary>
+    bool IsEmpty() const noexcept
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
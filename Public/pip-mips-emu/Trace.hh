@@ -0,0 +1,180 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_TRACE_HH
+#define PIP_MIPS_EMU_TRACE_HH
+
+#include <pip-mips-emu/AsyncWriter.hh>
+#include <pip-mips-emu/Components.hh>
+#include <pip-mips-emu/Memory.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+/// <summary>
+/// Magic number at the beginning of binary traces
+/// </summary>
+constexpr char TraceFileMagic[4] { '\x7F', 'P', 'M', 'T' };
+
+/// <summary>
+/// Version of the binary trace format written by <c>TraceWriter</c>
+/// </summary>
+constexpr uint32_t TraceFileVersion = 1;
+
+/// <summary>
+/// Size of the header of binary traces. The header consists of the magic number followed by the
+/// version, the flags of <c>TraceConfig</c>, the beginning and the end of the dumped range, each
+/// of which is a little endian word. Records follow the header.
+/// </summary>
+constexpr size_t TraceFileHeaderSize = 20;
+
+/// <summary>
+/// Size of a record. A record consists of its type, key and value, each of which is a little
+/// endian word.
+/// </summary>
+constexpr size_t TraceRecordSize = 12;
+
+/// <summary>
+/// Selects what is recorded for each cycle. The fields correspond to the options of runfile.
+/// </summary>
+struct TraceConfig
+{
+    /// <summary>
+    /// Records PCs in each pipeline stage as printed by <c>Handler::DumpPCs</c>
+    /// </summary>
+    bool dumpPCs = false;
+
+    /// <summary>
+    /// Records PC and r0 - r31 as printed by <c>Handler::DumpRegisters</c>
+    /// </summary>
+    bool dumpRegisters = false;
+
+    /// <summary>
+    /// Records the words in the range as printed by <c>Handler::DumpMemory</c>. Ignored unless
+    /// <c>dumpRegisters</c> is set.
+    /// </summary>
+    std::optional<Range> range = std::nullopt;
+};
+
+enum class TraceRecordType : uint32_t
+{
+    /// <summary>
+    /// Beginning of a cycle. The key is the cycle number.
+    /// </summary>
+    Cycle = 1,
+
+    /// <summary>
+    /// PC of a pipeline stage. The key is the index of the stage.
+    /// </summary>
+    PC = 2,
+
+    /// <summary>
+    /// Changed register. The key is the index of the register, where 32 is PC.
+    /// </summary>
+    Register = 3,
+
+    /// <summary>
+    /// Changed word in the range. The key is the index of the word in the range.
+    /// </summary>
+    Memory = 4,
+};
+
+/// <summary>
+/// Writes the state of each cycle as fixed-size records. PCs are written on every cycle, while
+/// registers and words are written only when they differ from the previous cycle.
+/// </summary>
+class TraceWriter
+{
+  private:
+    std::ostream*         _stream;
+    AsyncWriter*          _asyncWriter;
+    TraceConfig           _config;
+    std::vector<uint32_t> _registers;
+    std::vector<uint32_t> _words, _currentWords;
+    std::vector<char>     _buffer;
+    size_t                _bufferSize;
+    bool                  _hasSnapshot, _resync;
+
+  public:
+    /// <summary>
+    /// Writes the header to the given stream.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the range is invalid.</exception>
+    TraceWriter(std::ostream& stream, TraceConfig const& config);
+
+    /// <summary>
+    /// Queues the header to the given writer. If records are dropped by
+    /// <c>OverflowPolicy::Drop</c>, the next cycle records all registers and words, so the trace
+    /// stays decodable with the dropped cycles missing.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">Thrown when the range is invalid.</exception>
+    /// <exception cref="std::runtime_error">Thrown when the header is dropped.</exception>
+    TraceWriter(AsyncWriter& writer, TraceConfig const& config);
+
+  public:
+    /// <summary>
+    /// Records the state after the given cycle by comparing all registers and words with the
+    /// previous cycle.
+    /// </summary>
+    void WriteCycle(uint32_t cycle, Memory const& memory, Handler& handler);
+
+    /// <summary>
+    /// Records the state after the given cycle by comparing only the locations written by the
+    /// cycle, as recorded by <c>WriteRecorder</c>. Every cycle since the previous call to
+    /// <c>WriteCycle</c> must have been recorded.
+    /// </summary>
+    void WriteCycle(uint32_t             cycle,
+                    Memory const&        memory,
+                    Handler&             handler,
+                    AppliedWrites const& writes);
+
+    /// <summary>
+    /// Writes the buffered records to the stream or queues them to the writer. Returns
+    /// <c>false</c> if they are dropped.
+    /// </summary>
+    bool Flush();
+
+  private:
+    TraceWriter(std::ostream* stream, AsyncWriter* writer, TraceConfig const& config);
+
+    void BeginCycle(uint32_t cycle, Memory const& memory, Handler& handler, size_t numChanges);
+
+    void EndCycle();
+
+    void AppendRegister(Memory const& memory, uint32_t idx);
+
+    void Reserve(size_t numRecords);
+
+    void Append(TraceRecordType type, uint32_t key, uint32_t value) noexcept;
+};
+
+/// <summary>
+/// Selects what <c>DecodeTrace</c> prints for each cycle.
+/// </summary>
+enum class TraceDecodeMode : uint8_t
+{
+    /// <summary>
+    /// The full state rebuilt from the records, as printed by runfile
+    /// </summary>
+    Snapshots,
+
+    /// <summary>
+    /// PCs and only the registers and words recorded in the cycle, that is, the ones which
+    /// changed
+    /// </summary>
+    Changes,
+};
+
+/// <summary>
+/// Prints the state of each cycle from the given trace.
+/// </summary>
+/// <exception cref="std::runtime_error">Thrown when the trace is invalid.</exception>
+void DecodeTrace(std::istream&   is,
+                 std::ostream&   os,
+                 TraceDecodeMode mode = TraceDecodeMode::Snapshots);
+
+#endif
@@ -0,0 +1,84 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_VCD_HH
+#define PIP_MIPS_EMU_VCD_HH
+
+#include <pip-mips-emu/Dump.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/Observer.hh>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Selects the variables written by <c>VcdWriter</c>.
+/// </summary>
+struct VcdConfig
+{
+    /// <summary>
+    /// Patterns of the names of the registers and the signals to write, where <c>*</c> matches
+    /// any sequence of characters and <c>?</c> matches a character. If empty, all named registers
+    /// and signals are written.
+    /// </summary>
+    std::vector<std::string> patterns {};
+};
+
+/// <summary>
+/// Writes the named registers and the control signals of each cycle as a Value Change Dump
+/// (IEEE 1364). Each cycle is a time unit, and only the values which differ from the previous
+/// cycle are written.
+/// </summary>
+class VcdWriter : public EmulatorObserver
+{
+  private:
+    struct Variable
+    {
+        std::string name, id;
+        uint32_t    index;
+        uint32_t    width;
+        uint32_t    value;
+    };
+
+  private:
+    std::vector<Variable> _registers, _signals;
+    std::vector<uint16_t> _controls;
+    uint32_t              _cycle;
+    TextBuffer            _buffer;
+
+  public:
+    /// <summary>
+    /// Writes the declarations of the variables to the given stream.
+    /// </summary>
+    /// <param name="emulator">The emulator whose named registers and signals are written</param>
+    /// <exception cref="std::invalid_argument">Thrown when no register or signal matches the
+    /// patterns.</exception>
+    VcdWriter(std::ostream& stream, Emulator const& emulator, VcdConfig const& config = {});
+
+  public:
+    /// <summary>
+    /// Returns <c>true</c> if the given name matches the given pattern.
+    /// </summary>
+    static bool Matches(std::string_view pattern, std::string_view name) noexcept;
+
+  public:
+    void OnControlsResolved(Memory const&, std::vector<uint16_t> const& controls);
+
+    /// <summary>
+    /// Writes the values changed by the cycle.
+    /// </summary>
+    void OnCycleEnd(Memory const& memory);
+
+    /// <summary>
+    /// Writes the buffered changes to the stream.
+    /// </summary>
+    void Flush();
+
+  private:
+    void AppendValue(Variable const& variable);
+};
+
+#endif
@@ -0,0 +1,129 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef PIP_MIPS_EMU_WRITE_BUFFER_HH
+#define PIP_MIPS_EMU_WRITE_BUFFER_HH
+
+#include <pip-mips-emu/MemoryLevel.hh>
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Describes the capacity and the drain rate of a <c>WriteBuffer</c>.
+/// </summary>
+struct WriteBufferConfig
+{
+    /// <summary>
+    /// Maximum number of queued stores
+    /// </summary>
+    uint32_t numEntries = 4;
+
+    /// <summary>
+    /// Number of cycles to retire a store. Ignored if the buffer is backed by another
+    /// <c>MemoryLevel</c>.
+    /// </summary>
+    uint32_t drainCycles = 10;
+};
+
+/// <summary>
+/// Counters of a <c>WriteBuffer</c>.
+/// </summary>
+struct WriteBufferStats
+{
+    uint64_t stores = 0;
+    uint64_t loads  = 0;
+
+    /// <summary>
+    /// Loads served by a queued store
+    /// </summary>
+    uint64_t forwardedLoads = 0;
+
+    /// <summary>
+    /// Stores which found the buffer full
+    /// </summary>
+    uint64_t fullStalls = 0;
+
+    /// <summary>
+    /// Cycles the pipeline waited for a free entry
+    /// </summary>
+    uint64_t fullStallCycles = 0;
+
+    uint32_t maxOccupancy = 0;
+};
+
+/// <summary>
+/// Timing model of a FIFO write buffer in front of a memory level. Stores are queued and retired
+/// one at a time; loads to a queued word are forwarded from the buffer. Only addresses are
+/// tracked, and entries are matched at word granularity.
+/// </summary>
+class WriteBuffer : public MemoryLevel
+{
+  private:
+    struct Entry
+    {
+        uint64_t retireCycle;
+        uint32_t wordAddress;
+    };
+
+  private:
+    WriteBufferConfig  _config;
+    MemoryLevelPtr     _next;
+    std::vector<Entry> _entries;
+    size_t             _head, _size;
+    uint64_t           _cycle;
+    WriteBufferStats   _stats;
+
+  public:
+    /// <summary>
+    /// Creates an empty write buffer.
+    /// </summary>
+    /// <param name="config">The capacity and the drain rate of the buffer</param>
+    /// <param name="next">The level which receives retired stores and serves the other loads. If
+    /// <c>nullptr</c> is given, retiring a store takes <c>WriteBufferConfig::drainCycles</c>
+    /// cycles and loads are served immediately.</param>
+    /// <exception cref="std::invalid_argument">Thrown when the capacity is zero.</exception>
+    explicit WriteBuffer(WriteBufferConfig const& config, MemoryLevelPtr next = nullptr);
+
+  public:
+    WriteBufferConfig const& GetConfig() const noexcept
+    {
+        return _config;
+    }
+
+    WriteBufferStats const& GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+    size_t GetOccupancy() const noexcept
+    {
+        return _size;
+    }
+
+  public:
+    /// <summary>
+    /// Queues a store, or looks up the buffer for a load.
+    /// </summary>
+    virtual uint32_t Access(uint32_t address, AccessType type) noexcept override;
+
+    /// <summary>
+    /// Retires the stores which have been written to the next level.
+    /// </summary>
+    virtual void Tick() noexcept override;
+
+    /// <summary>
+    /// Discards all entries and clears the counters.
+    /// </summary>
+    void Reset() noexcept;
+
+  private:
+    Entry& At(size_t idx) noexcept
+    {
+        return _entries[(_head + idx) % _entries.size()];
+    }
+
+    void Retire() noexcept;
+};
+
+#endif
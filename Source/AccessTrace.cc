@@ -0,0 +1,195 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/AccessTrace.hh>
+#include <pip-mips-emu/Common.hh>
+
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+
+namespace
+{
+
+// Tag, cycle, PC and address
+constexpr size_t MaxRecordSize = 1 + 10 + 5 + 5;
+
+char* PutVarint(char* ptr, uint64_t value) noexcept
+{
+    while (value >= 0x80)
+    {
+        *ptr++ = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *ptr++ = static_cast<char>(value);
+    return ptr;
+}
+
+uint32_t ZigZag(uint32_t current, uint32_t last) noexcept
+{
+    int32_t const delta = static_cast<int32_t>(current - last);
+    return (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+}
+
+uint32_t UnZigZag(uint32_t last, uint32_t value) noexcept
+{
+    return last + ((value >> 1) ^ (0 - (value & 1)));
+}
+
+}
+
+AccessTraceWriter::AccessTraceWriter(AsyncWriter& writer) :
+    _writer { writer },
+    _cycle { 0 },
+    _lastCycle { 0 },
+    _lastPC { 0 },
+    _lastAddress { 0 },
+    _buffer(BufferSize + MaxRecordSize),
+    _bufferSize { 0 },
+    _numRecords { 0 }
+{
+    char header[AccessTraceFileHeaderSize];
+    std::memcpy(header, AccessTraceFileMagic, sizeof(AccessTraceFileMagic));
+    PutLittleEndianWord(header + 4, AccessTraceFileVersion);
+    if (!_writer.Write(header, sizeof(header)))
+        throw std::runtime_error { "Memory accesses are dropped" };
+}
+
+void AccessTraceWriter::OnMemoryAccess(StageAccess const& access)
+{
+    Append(access.kind, access.size, access.pc, access.address);
+    if (_bufferSize >= BufferSize)
+        Flush();
+}
+
+void AccessTraceWriter::Flush()
+{
+    if (_bufferSize == 0)
+        return;
+
+    bool const queued = _writer.Write(_buffer.data(), _bufferSize);
+    _bufferSize       = 0;
+    if (!queued)
+        throw std::runtime_error { "Memory accesses are dropped" };
+}
+
+void AccessTraceWriter::Append(AccessKind kind,
+                               uint32_t   size,
+                               uint32_t   pc,
+                               uint32_t   address) noexcept
+{
+    uint8_t const sizeCode = size == 4 ? 2 : size == 2 ? 1 : 0;
+
+    char* ptr = _buffer.data() + _bufferSize;
+    *ptr++    = static_cast<char>(static_cast<uint8_t>(kind) | sizeCode << 2);
+    ptr       = PutVarint(ptr, _cycle - _lastCycle);
+    ptr       = PutVarint(ptr, ZigZag(pc, _lastPC));
+    if (kind != AccessKind::Fetch)
+    {
+        ptr          = PutVarint(ptr, ZigZag(address, _lastAddress));
+        _lastAddress = address;
+    }
+
+    _bufferSize = static_cast<size_t>(ptr - _buffer.data());
+    _lastCycle  = _cycle;
+    _lastPC     = pc;
+    ++_numRecords;
+}
+
+AccessTraceReader::AccessTraceReader(std::istream& stream) :
+    _stream { stream }, _last { AccessKind::Fetch, 0, 0, 0, 0 }
+{
+    char header[AccessTraceFileHeaderSize];
+    if (!_stream.read(header, sizeof(header))
+        || std::memcmp(header, AccessTraceFileMagic, sizeof(AccessTraceFileMagic)) != 0)
+        throw std::runtime_error { "Not a memory access trace" };
+    if (GetLittleEndianWord(header + 4) != AccessTraceFileVersion)
+        throw std::runtime_error { "Unsupported version of memory access trace" };
+}
+
+bool AccessTraceReader::Next(AccessRecord& record)
+{
+    int const tag = _stream.get();
+    if (tag == std::istream::traits_type::eof())
+        return false;
+    if ((tag & 0b11) > static_cast<int>(AccessKind::Store) || (tag >> 2) > 2)
+        throw std::runtime_error { "Invalid memory access record" };
+
+    AccessKind const kind = static_cast<AccessKind>(tag & 0b11);
+    _last.kind            = kind;
+    _last.size            = 1u << (tag >> 2);
+    _last.cycle += ReadVarint();
+    _last.pc = UnZigZag(_last.pc, static_cast<uint32_t>(ReadVarint()));
+    if (kind == AccessKind::Fetch)
+    {
+        record         = _last;
+        record.address = _last.pc;
+    }
+    else
+    {
+        _last.address = UnZigZag(_last.address, static_cast<uint32_t>(ReadVarint()));
+        record        = _last;
+    }
+    return true;
+}
+
+uint64_t AccessTraceReader::ReadVarint()
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int const byte = _stream.get();
+        if (byte == std::istream::traits_type::eof())
+            throw std::runtime_error { "Truncated memory access record" };
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw std::runtime_error { "Invalid memory access record" };
+}
+
+AccessReplayStats ReplayAccessTrace(std::istream& stream,
+                                    MemoryLevel*  instructionLevel,
+                                    MemoryLevel*  dataLevel)
+{
+    AccessTraceReader reader { stream };
+    AccessReplayStats stats;
+    AccessRecord      record;
+
+    // The data level is ticked at the beginning of MemoryAccess, after the fetch of the cycle
+    uint64_t tickedCycle = 0;
+    auto     tickUntil   = [&](uint64_t cycle) {
+        for (; tickedCycle < cycle; ++tickedCycle)
+        {
+            if (dataLevel)
+                dataLevel->Tick();
+        }
+    };
+
+    while (reader.Next(record))
+    {
+        if (record.kind == AccessKind::Fetch)
+        {
+            tickUntil(record.cycle - 1);
+            ++stats.fetches;
+            if (instructionLevel)
+            {
+                stats.instructionStallCycles
+                    += instructionLevel->Access(record.pc, AccessType::Read);
+            }
+        }
+        else
+        {
+            tickUntil(record.cycle);
+            bool const isStore = record.kind == AccessKind::Store;
+            ++(isStore ? stats.stores : stats.loads);
+            if (dataLevel)
+            {
+                stats.dataStallCycles += dataLevel->Access(
+                    record.address, isStore ? AccessType::Write : AccessType::Read);
+            }
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,266 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Allocations.hh>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+#if defined(PIP_MIPS_EMU_COUNT_ALLOCATIONS) && defined(_WIN32)
+#    include <malloc.h>
+#endif
+
+namespace
+{
+
+// Counted per thread, so that the writer threads do not disturb the emulation thread
+thread_local AllocationCounts _counts;
+
+char const* const PhaseNames[] {
+    "controllers", "tick datapaths", "apply deltas", "tock datapaths", "handler",
+};
+
+}
+
+#if defined(PIP_MIPS_EMU_COUNT_ALLOCATIONS)
+
+namespace
+{
+
+void* AllocateAligned(std::size_t size, std::size_t alignment) noexcept
+{
+#    if defined(_WIN32)
+    return _aligned_malloc(size ? size : 1, alignment);
+#    else
+    // aligned_alloc requires the size to be a positive multiple of the alignment
+    if (size > SIZE_MAX - alignment)
+        return nullptr;
+    return std::aligned_alloc(alignment, size ? (size + alignment - 1) / alignment * alignment
+                                              : alignment);
+#    endif
+}
+
+void FreeAligned(void* ptr) noexcept
+{
+#    if defined(_WIN32)
+    _aligned_free(ptr);
+#    else
+    std::free(ptr);
+#    endif
+}
+
+/// <summary>
+/// Counts an allocation and retries it through the new handler as the replaced operators do.
+/// </summary>
+/// <exception cref="std::bad_alloc">Thrown when the memory is exhausted.</exception>
+void* Allocate(std::size_t size, std::size_t alignment)
+{
+    ++_counts.allocations;
+    _counts.bytes += size;
+
+    for (;;)
+    {
+        void* ptr = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                        ? AllocateAligned(size, alignment)
+                        : std::malloc(size ? size : 1);
+        if (ptr)
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc {};
+        handler();
+    }
+}
+
+void* AllocateNoThrow(std::size_t size, std::size_t alignment) noexcept
+{
+    try
+    {
+        return Allocate(size, alignment);
+    }
+    catch (std::bad_alloc const&)
+    {
+        return nullptr;
+    }
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    return Allocate(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+    return Allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size, 0);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+
+// The aligned overloads free the memory of the aligned operator new, which may have used its own
+// allocator, so they are replaced as well
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    if (static_cast<std::size_t>(alignment) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        FreeAligned(ptr);
+    else
+        std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+#endif
+
+AllocationCounts GetAllocationCounts() noexcept
+{
+    return _counts;
+}
+
+AllocationProfiler::AllocationProfiler(Emulator const& emulator) noexcept :
+    _numTickDatapaths { emulator.GetNumTickDatapaths() },
+    _last { GetAllocationCounts() },
+    _phases {},
+    _cycles { 0 }
+{}
+
+void AllocationProfiler::OnHostTicks(HostPhase phase, size_t index, uint64_t) noexcept
+{
+    AllocationPhase allocationPhase = AllocationPhase::Handler;
+    switch (phase)
+    {
+    case HostPhase::Controller: allocationPhase = AllocationPhase::Controllers; break;
+    case HostPhase::Datapath:
+        allocationPhase = index < _numTickDatapaths ? AllocationPhase::TickDatapaths
+                                                    : AllocationPhase::TockDatapaths;
+        break;
+    case HostPhase::ApplyDeltas: allocationPhase = AllocationPhase::ApplyDeltas; break;
+    case HostPhase::Handler: allocationPhase = AllocationPhase::Handler; break;
+    }
+
+    AllocationCounts const current = GetAllocationCounts();
+    AllocationCounts&      counts  = _phases[static_cast<size_t>(allocationPhase)];
+    counts.allocations += current.allocations - _last.allocations;
+    counts.bytes += current.bytes - _last.bytes;
+    _last = current;
+}
+
+void AllocationProfiler::WriteReport(std::ostream& stream) const
+{
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    auto const perCycle = [&](uint64_t value) {
+        return _cycles ? static_cast<double>(value) / _cycles : 0.0;
+    };
+
+    stream << "Allocations of " << _cycles << " cycles:\n";
+    stream << std::setw(14) << "allocations" << std::setw(14) << "bytes" << std::setw(14)
+           << "allocs/cycle" << std::setw(14) << "bytes/cycle"
+           << "  phase\n";
+
+    AllocationCounts total;
+    for (size_t i = 0; i < NumAllocationPhases; ++i)
+    {
+        AllocationCounts const& counts = _phases[i];
+        stream << std::setw(14) << counts.allocations << std::setw(14) << counts.bytes
+               << std::setw(14) << perCycle(counts.allocations) << std::setw(14)
+               << perCycle(counts.bytes) << "  " << PhaseNames[i] << '\n';
+
+        total.allocations += counts.allocations;
+        total.bytes += counts.bytes;
+    }
+    stream << std::setw(14) << total.allocations << std::setw(14) << total.bytes << std::setw(14)
+           << perCycle(total.allocations) << std::setw(14) << perCycle(total.bytes)
+           << "  total\n";
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
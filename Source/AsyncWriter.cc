@@ -0,0 +1,177 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/AsyncWriter.hh>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <tuple>
+
+#if defined(_WIN32)
+#    include <fcntl.h>
+#    include <io.h>
+#    include <sys/stat.h>
+#else
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace
+{
+
+/// <summary>
+/// Time the writer thread sleeps for when the ring buffer is empty
+/// </summary>
+constexpr std::chrono::milliseconds IdleInterval { 1 };
+
+int OpenFile(std::filesystem::path const& path) noexcept
+{
+#if defined(_WIN32)
+    return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+/// <summary>
+/// Writes all of the given bytes. Returns <c>false</c> on an I/O error.
+/// </summary>
+bool WriteFile(int fd, char const* data, size_t size) noexcept
+{
+    while (size != 0)
+    {
+#if defined(_WIN32)
+        int const result = _write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+#else
+        ssize_t const result = write(fd, data, size);
+#endif
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        data += result;
+        size -= static_cast<size_t>(result);
+    }
+    return true;
+}
+
+void CloseFile(int fd) noexcept
+{
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+}
+
+AsyncWriter::AsyncWriter(std::filesystem::path const& path, AsyncWriterConfig const& config) :
+    _ring { config.capacity },
+    _policy { config.policy },
+    _fd { OpenFile(path) },
+    _closing { false },
+    _failed { false },
+    _writtenBytes { 0 },
+    _droppedBytes { 0 },
+    _blockedWrites { 0 }
+{
+    if (_fd < 0)
+        throw std::runtime_error { "Cannot create the file" };
+
+    _thread = std::thread { &AsyncWriter::Drain, this };
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    try
+    {
+        Close();
+    }
+    catch (...)
+    {}
+}
+
+AsyncWriterStats AsyncWriter::GetStats() const noexcept
+{
+    return AsyncWriterStats {
+        _writtenBytes.load(std::memory_order_relaxed),
+        _droppedBytes,
+        _blockedWrites,
+    };
+}
+
+bool AsyncWriter::Write(char const* data, size_t size)
+{
+    size_t const capacity = _ring.GetCapacity();
+    if (size <= capacity && _ring.TryPush(data, size))
+        return true;
+
+    if (_policy == OverflowPolicy::Drop)
+    {
+        _droppedBytes += size;
+        return false;
+    }
+
+    ++_blockedWrites;
+    while (size != 0)
+    {
+        size_t const count = std::min(size, capacity);
+        while (!_ring.TryPush(data, count)) std::this_thread::yield();
+
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+void AsyncWriter::Close()
+{
+    if (!_thread.joinable())
+        return;
+
+    _closing.store(true, std::memory_order_release);
+    _thread.join();
+    CloseFile(_fd);
+
+    if (_failed.load(std::memory_order_relaxed))
+        throw std::runtime_error { "Cannot write the file" };
+}
+
+void AsyncWriter::Drain() noexcept
+{
+    while (true)
+    {
+        auto [data, size] = _ring.Peek();
+        if (size == 0)
+        {
+            // Bytes pushed before Close is called are visible once the flag is seen
+            if (_closing.load(std::memory_order_acquire))
+            {
+                std::tie(data, size) = _ring.Peek();
+                if (size == 0)
+                    return;
+            }
+            else
+            {
+                std::this_thread::sleep_for(IdleInterval);
+                continue;
+            }
+        }
+
+        // After an I/O error the bytes are discarded so that the producer is never blocked
+        if (!_failed.load(std::memory_order_relaxed))
+        {
+            if (WriteFile(_fd, data, size))
+                _writtenBytes.fetch_add(size, std::memory_order_relaxed);
+            else
+                _failed.store(true, std::memory_order_relaxed);
+        }
+        _ring.Pop(size);
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Common.hh>
+
+#include <stdexcept>
+
+namespace
+{
+
+constexpr uint64_t RandomSeed = 0x9E3779B97F4A7C15;
+
+}
+
+Cache::Cache(CacheConfig const& config, MemoryLevelPtr next) :
+    _config { config },
+    _next { std::move(next) },
+    _clock { 0 },
+    _random { RandomSeed }
+{
+    if (!IsPowerOfTwo(_config.size))
+        throw std::invalid_argument { "cache size must be a power of two" };
+
+    if (!IsPowerOfTwo(_config.lineSize) || _config.lineSize < 4)
+        throw std::invalid_argument { "cache line size must be a power of two not less than 4" };
+
+    if (_config.associativity == 0
+        || _config.size % (_config.lineSize * _config.associativity) != 0)
+        throw std::invalid_argument { "invalid cache associativity" };
+
+    uint32_t const numSets = _config.size / _config.lineSize / _config.associativity;
+    if (!IsPowerOfTwo(numSets))
+        throw std::invalid_argument { "number of cache sets must be a power of two" };
+
+    _offsetBits = Log2(_config.lineSize);
+    _setMask    = numSets - 1;
+    _lines.resize(static_cast<size_t>(numSets) * _config.associativity);
+    Reset();
+}
+
+uint32_t Cache::Access(uint32_t address, AccessType type) noexcept
+{
+    uint32_t const lineAddress = address >> _offsetBits;
+    uint32_t const setIdx      = lineAddress & _setMask;
+    bool const     isWrite     = type == AccessType::Write;
+    bool const     writeBack   = _config.writePolicy == WritePolicy::WriteBack;
+
+    Line* const set = _lines.data() + static_cast<size_t>(setIdx) * _config.associativity;
+    ++_clock;
+
+    for (uint32_t i = 0; i < _config.associativity; ++i)
+    {
+        Line& line = set[i];
+        if (line.valid && line.tag == lineAddress)
+        {
+            line.lastUse = _clock;
+            if (!isWrite)
+            {
+                ++_stats.readHits;
+                return 0;
+            }
+
+            ++_stats.writeHits;
+            if (writeBack)
+            {
+                line.dirty = true;
+                return 0;
+            }
+            return Transfer(address, AccessType::Write);
+        }
+    }
+
+    if (!isWrite)
+        ++_stats.readMisses;
+    else
+        ++_stats.writeMisses;
+
+    if (isWrite && !writeBack)
+        return Transfer(address, AccessType::Write);
+
+    uint32_t stall  = 0;
+    Line&    victim = SelectVictim(set);
+    if (victim.valid && victim.dirty)
+    {
+        ++_stats.writeBacks;
+        stall += Transfer(victim.tag << _offsetBits, AccessType::Write);
+    }
+    stall += Transfer(lineAddress << _offsetBits, AccessType::Read);
+
+    victim.lastUse = _clock;
+    victim.tag     = lineAddress;
+    victim.valid   = true;
+    victim.dirty   = isWrite;
+
+    return stall;
+}
+
+void Cache::Tick() noexcept
+{
+    if (_next)
+        _next->Tick();
+}
+
+void Cache::Reset() noexcept
+{
+    for (auto& line : _lines) line = Line { 0, 0, false, false };
+
+    _clock  = 0;
+    _random = RandomSeed;
+    _stats  = CacheStats {};
+}
+
+Cache::Line& Cache::SelectVictim(Line* set) noexcept
+{
+    uint32_t const associativity = _config.associativity;
+    for (uint32_t i = 0; i < associativity; ++i)
+    {
+        if (!set[i].valid)
+            return set[i];
+    }
+
+    if (_config.replacement == ReplacementPolicy::Random)
+    {
+        // xorshift64
+        _random ^= _random << 13;
+        _random ^= _random >> 7;
+        _random ^= _random << 17;
+        return set[_random % associativity];
+    }
+
+    Line* victim = set;
+    for (uint32_t i = 1; i < associativity; ++i)
+    {
+        if (set[i].lastUse < victim->lastUse)
+            victim = set + i;
+    }
+    return *victim;
+}
+
+uint32_t Cache::Transfer(uint32_t address, AccessType type) noexcept
+{
+    if (_next)
+        return _next->Access(address, type);
+    else
+        return _config.missPenalty;
+}
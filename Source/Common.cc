@@ -3,29 +3,147 @@
 
 #include <pip-mips-emu/Common.hh>
 
-#include <limits>
-#include <regex>
-#include <string>
+#include <array>
+#include <cstring>
+
+namespace
+{
+
+constexpr uint8_t InvalidHexDigit = 0xFF;
+
+constexpr std::array<uint8_t, 256> MakeHexDigits() noexcept
+{
+    std::array<uint8_t, 256> rtn {};
+    for (auto& digit : rtn) digit = InvalidHexDigit;
+
+    for (uint8_t i = 0; i < 10; ++i) rtn['0' + i] = i;
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+        rtn['a' + i] = 10 + i;
+        rtn['A' + i] = 10 + i;
+    }
+
+    return rtn;
+}
+
+constexpr std::array<uint8_t, 256> HexDigits = MakeHexDigits();
+
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4F;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5;
+
+constexpr uint64_t RotateLeft(uint64_t value, int shift) noexcept
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint64_t Read64(uint8_t const* ptr) noexcept
+{
+    uint64_t rtn;
+    std::memcpy(&rtn, ptr, sizeof(rtn));
+    return rtn;
+}
+
+inline uint32_t Read32(uint8_t const* ptr) noexcept
+{
+    uint32_t rtn;
+    std::memcpy(&rtn, ptr, sizeof(rtn));
+    return rtn;
+}
+
+constexpr uint64_t Round(uint64_t acc, uint64_t input) noexcept
+{
+    return RotateLeft(acc + input * Prime2, 31) * Prime1;
+}
+
+constexpr uint64_t MergeRound(uint64_t acc, uint64_t value) noexcept
+{
+    return (acc ^ Round(0, value)) * Prime1 + Prime4;
+}
+
+}
 
 bool ParseWord(char const* begin, char const* end, uint32_t& out) noexcept
 {
-    std::regex  re { "^ *0x([0-9a-fA-F]+) *$" };
-    std::cmatch match;
+    while (begin != end && *begin == ' ') ++begin;
+    while (begin != end && *(end - 1) == ' ') --end;
+
+    if (end - begin < 3 || begin[0] != '0' || begin[1] != 'x')
+        return false;
+    begin += 2;
 
-    if (!std::regex_match(begin, end, match, re))
+    // Leading zeros do not count toward the 32 bits
+    while (begin != end - 1 && *begin == '0') ++begin;
+    if (end - begin > 8)
         return false;
 
-    try
+    uint32_t value = 0;
+    for (; begin != end; ++begin)
     {
-        uint64_t u = std::stoull(match[1].str(), nullptr, 16);
-        if (static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) < u)
+        uint8_t const digit = HexDigits[static_cast<uint8_t>(*begin)];
+        if (digit == InvalidHexDigit)
             return false;
 
-        out = static_cast<uint32_t>(u);
-        return true;
+        value = value << 4 | digit;
     }
-    catch (...)
+
+    out = value;
+    return true;
+}
+
+uint64_t Hash64(void const* data, size_t size, uint64_t seed) noexcept
+{
+    uint8_t const*       ptr = static_cast<uint8_t const*>(data);
+    uint8_t const* const end = ptr + size;
+
+    uint64_t hash;
+    if (size >= 32)
     {
-        return false;
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+
+        for (; end - ptr >= 32; ptr += 32)
+        {
+            v1 = Round(v1, Read64(ptr + 0));
+            v2 = Round(v2, Read64(ptr + 8));
+            v3 = Round(v3, Read64(ptr + 16));
+            v4 = Round(v4, Read64(ptr + 24));
+        }
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    for (; end - ptr >= 8; ptr += 8)
+        hash = RotateLeft(hash ^ Round(0, Read64(ptr)), 27) * Prime1 + Prime4;
+
+    if (end - ptr >= 4)
+    {
+        hash = RotateLeft(hash ^ (static_cast<uint64_t>(Read32(ptr)) * Prime1), 23) * Prime2
+               + Prime3;
+        ptr += 4;
     }
+
+    for (; ptr != end; ++ptr) hash = RotateLeft(hash ^ (*ptr * Prime5), 11) * Prime1;
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+
+    return hash;
 }
@@ -0,0 +1,169 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Counters.hh>
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+PipelineTracker::PipelineTracker(Emulator const& emulator) :
+    _nextPCType { emulator.FindSignal("nextPCType") },
+    _pipelineState { emulator.FindSignal("pipelineState") },
+    _ifIdPC { emulator.FindRegister("IF_ID_PC") },
+    _exMemPC { emulator.FindRegister("EX_MEM_PC") },
+    _memWbPC { emulator.FindRegister("MEM_WB_PC") },
+    _memStallCycles { emulator.FindRegister("MEM_StallCycles") },
+    _state { PipelineState::Normal },
+    _inserted { SlotCause::Fill, 0, 0 },
+    _numFetched { 0 }
+{
+    _slots.fill(PipelineSlot { SlotCause::Fill, 0, 0 });
+}
+
+void PipelineTracker::Resolve(Memory const& memory, std::vector<uint16_t> const& controls)
+{
+    _state = static_cast<PipelineState>(controls[_pipelineState]);
+    switch (_state)
+    {
+    case PipelineState::Normal:
+    {
+        uint32_t const pc      = memory.GetRegister(Memory::PC);
+        uint32_t const textEnd = Address::MakeText(memory.GetTextSize());
+        _inserted = pc < textEnd ? PipelineSlot { SlotCause::Instruction, pc, _numFetched++ }
+                                 : PipelineSlot { SlotCause::Fill, 0, 0 };
+        break;
+    }
+    case PipelineState::Stalled:
+    {
+        // The instruction in ID waits for the load in EX
+        _inserted = PipelineSlot { SlotCause::LoadUse, memory.GetRegister(_ifIdPC), 0 };
+        break;
+    }
+    case PipelineState::MemoryStalled:
+    {
+        // A data miss was issued by the instruction now in MEM/WB, and an instruction miss by
+        // the one now in IF/ID
+        uint32_t const culprit = memory.GetRegister(_memStallCycles) ? _memWbPC : _ifIdPC;
+
+        _inserted = PipelineSlot { SlotCause::Memory, memory.GetRegister(culprit), 0 };
+        break;
+    }
+    case PipelineState::Flushed:
+    {
+        bool const jump = static_cast<NextPCType>(controls[_nextPCType]) == NextPCType::JumpResult;
+
+        _inserted.cause    = jump ? SlotCause::Jump : SlotCause::Branch;
+        _inserted.pc       = memory.GetRegister(_ifIdPC);
+        _inserted.sequence = 0;
+        break;
+    }
+    case PipelineState::Flushed3:
+    {
+        _inserted = PipelineSlot { SlotCause::Misprediction, memory.GetRegister(_exMemPC), 0 };
+        break;
+    }
+    }
+}
+
+PipelineSlot const& PipelineTracker::Advance() noexcept
+{
+    constexpr size_t IF_ID = 0, ID_EX = 1, EX_MEM = 2, MEM_WB = 3, WB = 4;
+
+    switch (_state)
+    {
+    case PipelineState::Normal:
+    case PipelineState::Flushed:
+    {
+        std::copy_backward(_slots.begin(), _slots.end() - 1, _slots.end());
+        _slots[IF_ID] = _inserted;
+        break;
+    }
+    case PipelineState::Stalled:
+    {
+        std::copy_backward(_slots.begin() + ID_EX, _slots.end() - 1, _slots.end());
+        _slots[ID_EX] = _inserted;
+        break;
+    }
+    case PipelineState::MemoryStalled:
+    {
+        _slots[WB] = _inserted;
+        break;
+    }
+    case PipelineState::Flushed3:
+    {
+        _slots[WB]     = _slots[MEM_WB];
+        _slots[MEM_WB] = _slots[EX_MEM];
+        _slots[EX_MEM] = _slots[ID_EX] = _slots[IF_ID] = _inserted;
+        break;
+    }
+    }
+
+    return _slots[WB];
+}
+
+CounterCollector::CounterCollector(Emulator const& emulator) :
+    _handler { *emulator.GetHandler() }, _tracker { emulator }
+{}
+
+void CounterCollector::OnControlsResolved(Memory const&                memory,
+                                          std::vector<uint16_t> const& controls)
+{
+    _tracker.Resolve(memory, controls);
+    switch (_tracker.GetInsertedCause())
+    {
+    case SlotCause::Jump: ++_counters.jumpFlushes; break;
+    case SlotCause::Branch: ++_counters.branchFlushes; break;
+    case SlotCause::Misprediction: ++_counters.mispredictionFlushes; break;
+    default: break;
+    }
+}
+
+void CounterCollector::OnCycleEnd(Memory const& memory) noexcept
+{
+    PipelineSlot const& slot = _tracker.Advance();
+
+    ++_counters.cycles;
+    if (uint32_t const numCommitted = _handler.CalcNumInstructions(memory))
+    {
+        _counters.instructions += numCommitted;
+        return;
+    }
+
+    switch (slot.cause)
+    {
+    case SlotCause::Instruction:
+    case SlotCause::Fill: ++_counters.fillCycles; break;
+    case SlotCause::LoadUse: ++_counters.loadUseStalls; break;
+    case SlotCause::Memory: ++_counters.memoryStalls; break;
+    case SlotCause::Jump: ++_counters.jumpFlushCycles; break;
+    case SlotCause::Branch: ++_counters.branchFlushCycles; break;
+    case SlotCause::Misprediction: ++_counters.mispredictionFlushCycles; break;
+    }
+}
+
+void WriteCountersJson(PipelineCounters const& counters, std::ostream& stream)
+{
+    stream << "{\n";
+    stream << "  \"cycles\": " << counters.cycles << ",\n";
+    stream << "  \"instructions\": " << counters.instructions << ",\n";
+    stream << "  \"cpi\": " << counters.GetCPI() << ",\n";
+    stream << "  \"fillCycles\": " << counters.fillCycles << ",\n";
+    stream << "  \"stallCycles\": {\n";
+    stream << "    \"total\": " << counters.GetStallCycles() << ",\n";
+    stream << "    \"loadUse\": " << counters.loadUseStalls << ",\n";
+    stream << "    \"memory\": " << counters.memoryStalls << "\n";
+    stream << "  },\n";
+    stream << "  \"flushCycles\": {\n";
+    stream << "    \"total\": " << counters.GetFlushCycles() << ",\n";
+    stream << "    \"jump\": " << counters.jumpFlushCycles << ",\n";
+    stream << "    \"branchID\": " << counters.branchFlushCycles << ",\n";
+    stream << "    \"misprediction\": " << counters.mispredictionFlushCycles << "\n";
+    stream << "  },\n";
+    stream << "  \"flushes\": {\n";
+    stream << "    \"jump\": " << counters.jumpFlushes << ",\n";
+    stream << "    \"branchID\": " << counters.branchFlushes << ",\n";
+    stream << "    \"misprediction\": " << counters.mispredictionFlushes << "\n";
+    stream << "  }\n";
+    stream << "}\n";
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/Coverage.hh>
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/InstructionMix.hh>
+
+#include <bitset>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+uint32_t HashText(Memory const& memory) noexcept
+{
+    uint32_t hash = 2166136261;
+    for (uint32_t offset = 0; offset < memory.GetTextSize(); offset += 4)
+    {
+        uint32_t const word = memory.GetWord(Address::MakeText(offset));
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            hash ^= (word >> shift) & 0xFF;
+            hash *= 16777619;
+        }
+    }
+    return hash;
+}
+
+Coverage::Coverage(uint32_t numWords, uint32_t textHash) :
+    _numWords { numWords }, _textHash { textHash }
+{
+    for (auto& bitmap : _bitmaps) bitmap.resize((numWords + 31) / 32);
+}
+
+Coverage::Coverage(Memory const& memory) : Coverage { memory.GetTextSize() / 4, HashText(memory) }
+{
+    for (uint32_t index = 0; index < _numWords; ++index)
+    {
+        if (Classify(memory.GetWord(Address::MakeText(index * 4))) == InstructionClass::Branch)
+            Set(CoverageKind::Branches, index);
+    }
+}
+
+uint32_t Coverage::Count(CoverageKind kind) const noexcept
+{
+    uint32_t count = 0;
+    for (uint32_t word : _bitmaps[static_cast<size_t>(kind)])
+        count += static_cast<uint32_t>(std::bitset<32> { word }.count());
+    return count;
+}
+
+uint32_t Coverage::CountBothDirections() const noexcept
+{
+    auto const& taken    = _bitmaps[static_cast<size_t>(CoverageKind::Taken)];
+    auto const& notTaken = _bitmaps[static_cast<size_t>(CoverageKind::NotTaken)];
+
+    uint32_t count = 0;
+    for (size_t i = 0; i < taken.size(); ++i)
+        count += static_cast<uint32_t>(std::bitset<32> { taken[i] & notTaken[i] }.count());
+    return count;
+}
+
+void Coverage::Merge(Coverage const& other)
+{
+    if (_numWords != other._numWords || _textHash != other._textHash)
+        throw std::invalid_argument { "The coverage is of another program" };
+
+    for (size_t kind = 0; kind < NumCoverageKinds; ++kind)
+    {
+        auto&       bitmap = _bitmaps[kind];
+        auto const& source = other._bitmaps[kind];
+        for (size_t i = 0; i < bitmap.size(); ++i) bitmap[i] |= source[i];
+    }
+}
+
+void Coverage::Write(std::ostream& stream) const
+{
+    std::vector<char> buffer(CoverageFileHeaderSize + NumCoverageKinds * _bitmaps[0].size() * 4);
+    char*             ptr = buffer.data();
+
+    std::memcpy(ptr, CoverageFileMagic, sizeof(CoverageFileMagic));
+    PutLittleEndianWord(ptr + 4, CoverageFileVersion);
+    PutLittleEndianWord(ptr + 8, _numWords);
+    PutLittleEndianWord(ptr + 12, _textHash);
+    ptr += CoverageFileHeaderSize;
+
+    for (auto const& bitmap : _bitmaps)
+    {
+        for (uint32_t word : bitmap)
+        {
+            PutLittleEndianWord(ptr, word);
+            ptr += 4;
+        }
+    }
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+Coverage Coverage::Read(std::istream& stream)
+{
+    char header[CoverageFileHeaderSize];
+    if (!stream.read(header, sizeof(header))
+        || std::memcmp(header, CoverageFileMagic, sizeof(CoverageFileMagic)) != 0)
+        throw std::runtime_error { "Not a coverage file" };
+    if (GetLittleEndianWord(header + 4) != CoverageFileVersion)
+        throw std::runtime_error { "Unsupported version of coverage" };
+
+    uint32_t const numWords = GetLittleEndianWord(header + 8);
+    if (numWords > (DataBase - TextBase) / 4)
+        throw std::runtime_error { "Invalid number of words" };
+
+    Coverage          coverage { numWords, GetLittleEndianWord(header + 12) };
+    std::vector<char> buffer(coverage._bitmaps[0].size() * 4);
+    for (auto& bitmap : coverage._bitmaps)
+    {
+        if (!stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+            throw std::runtime_error { "Truncated coverage" };
+        for (size_t i = 0; i < bitmap.size(); ++i) bitmap[i] = GetLittleEndianWord(&buffer[i * 4]);
+    }
+
+    if (stream.peek() != std::istream::traits_type::eof())
+        throw std::runtime_error { "Trailing data after coverage" };
+    return coverage;
+}
+
+void Coverage::WriteSummary(std::ostream& stream) const
+{
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    auto const writeRow = [&](char const* name, uint32_t covered, uint32_t total) {
+        stream << std::setw(12) << name << std::setw(10) << covered << std::setw(10) << total
+               << std::setw(10) << (total ? 100.0 * covered / total : 0.0) << '\n';
+    };
+
+    uint32_t const branches = Count(CoverageKind::Branches);
+
+    stream << std::setw(12) << "" << std::setw(10) << "covered" << std::setw(10) << "total"
+           << std::setw(10) << "%" << '\n';
+    writeRow("words", Count(CoverageKind::Executed), _numWords);
+    writeRow("taken", Count(CoverageKind::Taken), branches);
+    writeRow("not taken", Count(CoverageKind::NotTaken), branches);
+    writeRow("both", CountBothDirections(), branches);
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void CoverageCollector::OnInstructionCommitted(Memory const& memory, uint32_t pc) noexcept
+{
+    uint32_t const index = (pc - TextBase) / 4;
+    if (index >= _coverage.GetNumWords())
+        return;
+
+    _coverage.Set(CoverageKind::Executed, index);
+    if (_coverage.Test(CoverageKind::Branches, index))
+    {
+        uint32_t const instruction = memory.GetWord(Address::MakeText(index * 4));
+        _coverage.Set(InstructionMix::IsBranchTaken(instruction, memory) ? CoverageKind::Taken
+                                                                         : CoverageKind::NotTaken,
+                      index);
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Coverage.hh>
+
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+// Merges coverage files written with '-coverage' by runs of the same program, and prints the
+// summary of the merged coverage. With a single input, only prints its summary.
+// Usage: covmerge [-o <output>] <coverage>...
+int main(int argc, char* argv[])
+{
+    try
+    {
+        int         first  = 1;
+        char const* output = nullptr;
+        if (argc > 2 && std::string { argv[1] } == "-o")
+        {
+            output = argv[2];
+            first  = 3;
+        }
+        if (first >= argc)
+            throw std::runtime_error { "Usage: covmerge [-o <output>] <coverage>..." };
+
+        std::optional<Coverage> merged;
+        for (int i = first; i < argc; ++i)
+        {
+            std::ifstream ifs { argv[i], std::ios::binary };
+            if (!ifs)
+                throw std::runtime_error { std::string { "File does not exist: " } + argv[i] };
+
+            Coverage coverage = Coverage::Read(ifs);
+            if (!merged)
+                merged = std::move(coverage);
+            else
+                merged->Merge(coverage);
+        }
+
+        if (output)
+        {
+            std::ofstream ofs { output, std::ios::binary };
+            merged->Write(ofs);
+            if (!ofs.flush())
+                throw std::runtime_error { "Cannot write the coverage file" };
+        }
+
+        merged->WriteSummary(std::cout);
+        return 0;
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+}
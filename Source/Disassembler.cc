@@ -0,0 +1,203 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Formats.hh>
+
+#include <charconv>
+#include <initializer_list>
+
+namespace
+{
+
+char const* const RegisterNames[] {
+    "$zero", "$at", "$v0", "$v1", "$a0", "$a1", "$a2", "$a3", "$t0", "$t1", "$t2",
+    "$t3",   "$t4", "$t5", "$t6", "$t7", "$s0", "$s1", "$s2", "$s3", "$s4", "$s5",
+    "$s6",   "$s7", "$t8", "$t9", "$k0", "$k1", "$gp", "$sp", "$fp", "$ra",
+};
+
+template <typename T>
+constexpr uint32_t Code(T value) noexcept
+{
+    return static_cast<uint32_t>(value);
+}
+
+std::string Hex(uint32_t value)
+{
+    char  buffer[10] { '0', 'x' };
+    char* end = std::to_chars(buffer + 2, buffer + sizeof(buffer), value, 16).ptr;
+    return std::string(buffer, end);
+}
+
+std::string Signed(uint32_t immediate)
+{
+    return std::to_string(static_cast<int16_t>(immediate & 0xFFFF));
+}
+
+std::string Format(char const* mnemonic, std::initializer_list<std::string> operands)
+{
+    std::string rtn { mnemonic };
+    char const* separator = " ";
+    for (auto const& operand : operands)
+    {
+        rtn += separator;
+        rtn += operand;
+        separator = ", ";
+    }
+    return rtn;
+}
+
+}
+
+std::string Disassemble(uint32_t instruction, uint32_t pc)
+{
+    uint32_t const operation   = (instruction >> 26) & 0b111111;
+    uint32_t const function    = (instruction >> 0) & 0b111111;
+    uint32_t const shiftAmount = (instruction >> 6) & 0b11111;
+    uint32_t const immediate   = (instruction >> 0) & 0xFFFF;
+
+    std::string const rs = RegisterNames[(instruction >> 21) & 0b11111];
+    std::string const rt = RegisterNames[(instruction >> 16) & 0b11111];
+    std::string const rd = RegisterNames[(instruction >> 11) & 0b11111];
+
+    if (instruction == 0)
+        return "nop";
+
+    if (operation == 0)
+    {
+        switch (function)
+        {
+        case Code(SRFormatFn::SLL): return Format("sll", { rd, rt, std::to_string(shiftAmount) });
+        case Code(SRFormatFn::SRL): return Format("srl", { rd, rt, std::to_string(shiftAmount) });
+        case Code(JRFormatFn::JR): return Format("jr", { rs });
+        case Code(RFormatFn::ADDU): return Format("addu", { rd, rs, rt });
+        case Code(RFormatFn::SUBU): return Format("subu", { rd, rs, rt });
+        case Code(RFormatFn::AND): return Format("and", { rd, rs, rt });
+        case Code(RFormatFn::OR): return Format("or", { rd, rs, rt });
+        case Code(RFormatFn::NOR): return Format("nor", { rd, rs, rt });
+        case Code(RFormatFn::SLTU): return Format("sltu", { rd, rs, rt });
+        }
+        return ".word " + Hex(instruction);
+    }
+
+    std::string const address = Signed(immediate) + "(" + rs + ")";
+    std::string const branch  = Hex(pc + 4 + static_cast<int16_t>(immediate) * 4);
+    std::string const jump    = Hex(((instruction & 0x03FFFFFF) << 2) | ((pc + 4) & 0xF0000000));
+    switch (operation)
+    {
+    case Code(IFormatOp::ADDIU): return Format("addiu", { rt, rs, Signed(immediate) });
+    case Code(IFormatOp::ANDI): return Format("andi", { rt, rs, Hex(immediate) });
+    case Code(IFormatOp::ORI): return Format("ori", { rt, rs, Hex(immediate) });
+    case Code(IFormatOp::SLTIU): return Format("sltiu", { rt, rs, Signed(immediate) });
+    case Code(IIFormatOp::LUI): return Format("lui", { rt, Hex(immediate) });
+    case Code(BIFormatOp::BEQ): return Format("beq", { rs, rt, branch });
+    case Code(BIFormatOp::BNE): return Format("bne", { rs, rt, branch });
+    case Code(OIFormatOp::LB): return Format("lb", { rt, address });
+    case Code(OIFormatOp::LW): return Format("lw", { rt, address });
+    case Code(OIFormatOp::SB): return Format("sb", { rt, address });
+    case Code(OIFormatOp::SW): return Format("sw", { rt, address });
+    case Code(JFormatOp::J): return Format("j", { jump });
+    case Code(JFormatOp::JAL): return Format("jal", { jump });
+    }
+    return ".word " + Hex(instruction);
+}
+
+char const* GetMnemonic(uint32_t instruction) noexcept
+{
+    uint32_t const operation = (instruction >> 26) & 0b111111;
+    uint32_t const function  = (instruction >> 0) & 0b111111;
+
+    if (operation == 0)
+    {
+        switch (function)
+        {
+        case Code(SRFormatFn::SLL): return "sll";
+        case Code(SRFormatFn::SRL): return "srl";
+        case Code(JRFormatFn::JR): return "jr";
+        case Code(RFormatFn::ADDU): return "addu";
+        case Code(RFormatFn::SUBU): return "subu";
+        case Code(RFormatFn::AND): return "and";
+        case Code(RFormatFn::OR): return "or";
+        case Code(RFormatFn::NOR): return "nor";
+        case Code(RFormatFn::SLTU): return "sltu";
+        }
+        return nullptr;
+    }
+
+    switch (operation)
+    {
+    case Code(IFormatOp::ADDIU): return "addiu";
+    case Code(IFormatOp::ANDI): return "andi";
+    case Code(IFormatOp::ORI): return "ori";
+    case Code(IFormatOp::SLTIU): return "sltiu";
+    case Code(IIFormatOp::LUI): return "lui";
+    case Code(BIFormatOp::BEQ): return "beq";
+    case Code(BIFormatOp::BNE): return "bne";
+    case Code(OIFormatOp::LB): return "lb";
+    case Code(OIFormatOp::LW): return "lw";
+    case Code(OIFormatOp::SB): return "sb";
+    case Code(OIFormatOp::SW): return "sw";
+    case Code(JFormatOp::J): return "j";
+    case Code(JFormatOp::JAL): return "jal";
+    }
+    return nullptr;
+}
+
+InstructionClass Classify(uint32_t instruction) noexcept
+{
+    uint32_t const operation = (instruction >> 26) & 0b111111;
+    uint32_t const function  = (instruction >> 0) & 0b111111;
+
+    if (instruction == 0)
+        return InstructionClass::Nop;
+
+    if (operation == 0)
+    {
+        switch (function)
+        {
+        case Code(JRFormatFn::JR): return InstructionClass::Jump;
+        case Code(SRFormatFn::SLL):
+        case Code(SRFormatFn::SRL):
+        case Code(RFormatFn::ADDU):
+        case Code(RFormatFn::SUBU):
+        case Code(RFormatFn::AND):
+        case Code(RFormatFn::OR):
+        case Code(RFormatFn::NOR):
+        case Code(RFormatFn::SLTU): return InstructionClass::Alu;
+        }
+        return InstructionClass::Unknown;
+    }
+
+    switch (operation)
+    {
+    case Code(IFormatOp::ADDIU):
+    case Code(IFormatOp::ANDI):
+    case Code(IFormatOp::ORI):
+    case Code(IFormatOp::SLTIU):
+    case Code(IIFormatOp::LUI): return InstructionClass::Alu;
+    case Code(BIFormatOp::BEQ):
+    case Code(BIFormatOp::BNE): return InstructionClass::Branch;
+    case Code(OIFormatOp::LB):
+    case Code(OIFormatOp::LW): return InstructionClass::Load;
+    case Code(OIFormatOp::SB):
+    case Code(OIFormatOp::SW): return InstructionClass::Store;
+    case Code(JFormatOp::J):
+    case Code(JFormatOp::JAL): return InstructionClass::Jump;
+    }
+    return InstructionClass::Unknown;
+}
+
+char const* GetClassName(InstructionClass instructionClass) noexcept
+{
+    switch (instructionClass)
+    {
+    case InstructionClass::Nop: return "nop";
+    case InstructionClass::Alu: return "alu";
+    case InstructionClass::Load: return "load";
+    case InstructionClass::Store: return "store";
+    case InstructionClass::Branch: return "branch";
+    case InstructionClass::Jump: return "jump";
+    case InstructionClass::Unknown: return "unknown";
+    }
+    return "unknown";
+}
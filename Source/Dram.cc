@@ -0,0 +1,58 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/Dram.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+Dram::Dram(DramConfig const& config) : _config { config }
+{
+    if (!IsPowerOfTwo(_config.numBanks))
+        throw std::invalid_argument { "number of DRAM banks must be a power of two" };
+
+    if (!IsPowerOfTwo(_config.rowSize))
+        throw std::invalid_argument { "DRAM row size must be a power of two" };
+
+    _columnBits = Log2(_config.rowSize);
+    _bankBits   = Log2(_config.numBanks);
+    _bankMask   = _config.numBanks - 1;
+    _openRows.resize(_config.numBanks);
+    Reset();
+}
+
+uint32_t Dram::Access(uint32_t address, AccessType) noexcept
+{
+    uint32_t const bank = (address >> _columnBits) & _bankMask;
+    uint32_t const row  = (address >> _columnBits) >> _bankBits;
+
+    uint32_t& openRow = _openRows[bank];
+    uint32_t  latency = _config.tCAS;
+    if (openRow == row)
+    {
+        ++_stats.rowHits;
+    }
+    else if (openRow == NoOpenRow)
+    {
+        ++_stats.rowMisses;
+        latency += _config.tRCD;
+    }
+    else
+    {
+        ++_stats.rowConflicts;
+        latency += _config.tRP + _config.tRCD;
+    }
+
+    // With the closed page policy the precharge is overlapped with the next idle period
+    openRow = _config.pagePolicy == PagePolicy::Open ? row : NoOpenRow;
+
+    _stats.totalLatency += latency;
+    return latency;
+}
+
+void Dram::Reset() noexcept
+{
+    std::fill(_openRows.begin(), _openRows.end(), NoOpenRow);
+    _stats = DramStats {};
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Dump.hh>
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+TextBuffer::~TextBuffer()
+{
+    try
+    {
+        Flush();
+    }
+    catch (...)
+    {}
+}
+
+void TextBuffer::WriteToStream(char const* data, size_t size)
+{
+    _stream.write(data, static_cast<std::streamsize>(size));
+}
+
+void WritePCs(Handler::PCs const& pcs, TextBuffer& buffer)
+{
+    buffer.Append("Current pipeline PC state:\n");
+
+    for (uint32_t i = 0; i < Handler::NumStages; ++i)
+    {
+        buffer.Append(i == 0 ? '{' : '|');
+        if (pcs[i])
+        {
+            buffer.Append("0x");
+            buffer.AppendHex(pcs[i]);
+        }
+    }
+    buffer.Append("}\n");
+}
+
+void WritePCs(Handler::PCs const& pcs, std::ostream& stream)
+{
+    TextBuffer buffer { stream };
+    WritePCs(pcs, buffer);
+}
+
+void WriteRegisters(uint32_t pc, uint32_t const* registers, TextBuffer& buffer)
+{
+    buffer.Append("Current register values:\n");
+    buffer.Append("------------------------------------\n");
+    buffer.Append("PC: 0x");
+    buffer.AppendHex(pc);
+    buffer.Append("\nRegisters:\n");
+
+    for (uint32_t idx = 0; idx < NumDumpedRegisters; ++idx)
+    {
+        buffer.Append('R');
+        buffer.AppendDecimal(idx);
+        buffer.Append(": 0x");
+        buffer.AppendHex(registers[idx]);
+        buffer.Append('\n');
+    }
+}
+
+void WriteRegisters(uint32_t pc, uint32_t const* registers, std::ostream& stream)
+{
+    TextBuffer buffer { stream };
+    WriteRegisters(pc, registers, buffer);
+}
+
+void WriteMemoryHeader(Range range, TextBuffer& buffer)
+{
+    buffer.Append("Memory content [0x");
+    buffer.AppendHex(range.begin);
+    buffer.Append("..0x");
+    buffer.AppendHex(range.end);
+    buffer.Append("]:\n");
+    buffer.Append("------------------------------------\n");
+}
+
+void WriteMemoryHeader(Range range, std::ostream& stream)
+{
+    TextBuffer buffer { stream };
+    WriteMemoryHeader(range, buffer);
+}
+
+void WriteMemoryWords(Address address, uint32_t const* words, size_t count, TextBuffer& buffer)
+{
+    for (size_t i = 0; i < count; ++i, address.MoveToNext())
+    {
+        buffer.Append("0x");
+        buffer.AppendHex(address);
+        buffer.Append(": 0x");
+        buffer.AppendHex(words[i]);
+        buffer.Append('\n');
+    }
+}
+
+void WriteMemoryWords(Address address, uint32_t const* words, size_t count, std::ostream& stream)
+{
+    TextBuffer buffer { stream };
+    WriteMemoryWords(address, words, count, buffer);
+}
+
+size_t CountMemoryWords(Range range)
+{
+    uint32_t const begin = range.begin;
+    uint32_t const end   = range.end;
+    if (begin > end)
+        throw std::invalid_argument { "invalid memory range" };
+
+    return static_cast<size_t>((end - begin) / 4 + 1);
+}
+
+void ReadMemoryWords(Memory const& memory, Range range, uint32_t* out) noexcept
+{
+    uint64_t current = range.begin;
+    while (current <= range.end)
+    {
+        // Read words up to the end of the range, without crossing the base of the data segment
+        uint64_t last = range.end;
+        if (current < DataBase)
+            last = std::min<uint64_t>(last, DataBase - 1);
+
+        size_t const count = static_cast<size_t>((last - current) / 4 + 1);
+        memory.ReadWords(Address::MakeFromWord(static_cast<uint32_t>(current)), out, count);
+
+        out += count;
+        current += count * 4;
+    }
+}
@@ -0,0 +1,214 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Elf.hh>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+constexpr uint8_t  ElfClass32             = 1;
+constexpr uint8_t  ElfDataMsb             = 2;
+constexpr uint8_t  ElfVersionCurrent      = 1;
+constexpr uint16_t ElfTypeExecutable      = 2;
+constexpr uint16_t ElfMachineMips         = 8;
+constexpr uint32_t ProgramTypeLoad        = 1;
+constexpr uint32_t SectionTypeSymbolTable = 2;
+
+constexpr size_t FileHeaderSize    = 52;
+constexpr size_t ProgramHeaderSize = 32;
+constexpr size_t SectionHeaderSize = 40;
+constexpr size_t SymbolEntrySize   = 16;
+
+constexpr uint64_t AddressSpaceEnd = uint64_t { 1 } << 32;
+
+uint16_t ReadHalf(uint8_t const* ptr) noexcept
+{
+    return static_cast<uint16_t>(ptr[0] << 8 | ptr[1]);
+}
+
+uint32_t ReadWord(uint8_t const* ptr) noexcept
+{
+    return static_cast<uint32_t>(ptr[0]) << 24 | static_cast<uint32_t>(ptr[1]) << 16
+           | static_cast<uint32_t>(ptr[2]) << 8 | static_cast<uint32_t>(ptr[3]) << 0;
+}
+
+constexpr bool IsInFile(size_t fileSize, uint64_t offset, uint64_t size) noexcept
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+constexpr uint64_t AlignToWord(uint64_t value) noexcept
+{
+    return (value + 3) & ~uint64_t { 3 };
+}
+
+struct LoadSegment
+{
+    uint32_t offset;
+    uint32_t address;
+    uint32_t fileSize;
+    uint32_t memorySize;
+};
+
+/// <summary>
+/// Reads the symbols of the symbol table described by the given section header.
+/// </summary>
+bool ReadSymbolTable(uint8_t const*       bytes,
+                     size_t               size,
+                     uint8_t const*       symbolTable,
+                     uint8_t const*       stringTable,
+                     std::vector<Symbol>& out)
+{
+    uint32_t const offset    = ReadWord(symbolTable + 16);
+    uint32_t const tableSize = ReadWord(symbolTable + 20);
+    uint32_t const entrySize = ReadWord(symbolTable + 36);
+
+    uint32_t const stringsOffset = ReadWord(stringTable + 16);
+    uint32_t const stringsSize   = ReadWord(stringTable + 20);
+
+    if (entrySize < SymbolEntrySize || !IsInFile(size, offset, tableSize)
+        || !IsInFile(size, stringsOffset, stringsSize))
+        return false;
+
+    char const*  strings    = reinterpret_cast<char const*>(bytes + stringsOffset);
+    size_t const numSymbols = tableSize / entrySize;
+
+    // The first entry is always the undefined symbol
+    for (size_t i = 1; i < numSymbols; ++i)
+    {
+        uint8_t const* entry = bytes + offset + i * entrySize;
+
+        uint32_t const nameIdx = ReadWord(entry + 0);
+        if (nameIdx >= stringsSize)
+            return false;
+
+        Symbol::Type type;
+        switch (entry[12] & 0xF)
+        {
+        case 0: type = Symbol::Type::NoType; break;
+        case 1: type = Symbol::Type::Object; break;
+        case 2: type = Symbol::Type::Function; break;
+        default: continue;
+        }
+
+        char const*  name       = strings + nameIdx;
+        size_t const nameLength = strnlen(name, stringsSize - nameIdx);
+        if (nameLength == 0)
+            continue;
+
+        out.push_back(Symbol {
+            std::string(name, nameLength),
+            ReadWord(entry + 4),
+            ReadWord(entry + 8),
+            type,
+        });
+    }
+
+    return true;
+}
+
+}
+
+FileReadResult ReadElfFile(uint8_t const* bytes, size_t size)
+{
+    if (size < FileHeaderSize || std::memcmp(bytes, ElfFileMagic, sizeof(ElfFileMagic)) != 0)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    if (bytes[4] != ElfClass32 || bytes[5] != ElfDataMsb || bytes[6] != ElfVersionCurrent)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    if (ReadHalf(bytes + 16) != ElfTypeExecutable || ReadHalf(bytes + 18) != ElfMachineMips)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    uint32_t const entryPoint        = ReadWord(bytes + 24);
+    uint32_t const programHeaders    = ReadWord(bytes + 28);
+    uint32_t const sectionHeaders    = ReadWord(bytes + 32);
+    uint16_t const programHeaderSize = ReadHalf(bytes + 42);
+    uint16_t const numProgramHeaders = ReadHalf(bytes + 44);
+    uint16_t const sectionHeaderSize = ReadHalf(bytes + 46);
+    uint16_t const numSectionHeaders = ReadHalf(bytes + 48);
+
+    if (programHeaderSize < ProgramHeaderSize
+        || !IsInFile(size, programHeaders, uint64_t { programHeaderSize } * numProgramHeaders))
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    // Calculate the sizes of the segments first so that each segment is copied only once
+    std::vector<LoadSegment> loadSegments;
+    uint64_t                 textSize = 0, dataSize = 0;
+    for (uint16_t i = 0; i < numProgramHeaders; ++i)
+    {
+        uint8_t const* header = bytes + programHeaders + uint64_t { i } * programHeaderSize;
+        if (ReadWord(header + 0) != ProgramTypeLoad)
+            continue;
+
+        LoadSegment segment {
+            ReadWord(header + 4),
+            ReadWord(header + 8),
+            ReadWord(header + 16),
+            ReadWord(header + 20),
+        };
+        if (segment.fileSize > segment.memorySize
+            || !IsInFile(size, segment.offset, segment.fileSize))
+            return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+
+        if (segment.memorySize == 0)
+            continue;
+
+        uint64_t const begin = segment.address;
+        uint64_t const end   = begin + segment.memorySize;
+        if (DataBase <= begin && end <= AddressSpaceEnd)
+            dataSize = std::max(dataSize, end - DataBase);
+        else if (TextBase <= begin && end <= DataBase)
+            textSize = std::max(textSize, end - TextBase);
+        else
+            return CannotRead { FileReadError::Type::InvalidFormat };
+
+        loadSegments.push_back(segment);
+    }
+
+    if (entryPoint % 4 != 0 || entryPoint < TextBase || entryPoint - TextBase > textSize)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    CanRead rtn {
+        std::vector<uint8_t>(static_cast<size_t>(AlignToWord(textSize)), 0),
+        std::vector<uint8_t>(static_cast<size_t>(AlignToWord(dataSize)), 0),
+        entryPoint,
+        {},
+    };
+
+    for (LoadSegment const& segment : loadSegments)
+    {
+        uint8_t* dest = segment.address < DataBase
+                            ? rtn.text.data() + (segment.address - TextBase)
+                            : rtn.data.data() + (segment.address - DataBase);
+        std::memcpy(dest, bytes + segment.offset, segment.fileSize);
+    }
+
+    // Section headers are optional for executables
+    if (numSectionHeaders == 0)
+        return rtn;
+
+    if (sectionHeaderSize < SectionHeaderSize
+        || !IsInFile(size, sectionHeaders, uint64_t { sectionHeaderSize } * numSectionHeaders))
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    for (uint16_t i = 0; i < numSectionHeaders; ++i)
+    {
+        uint8_t const* header = bytes + sectionHeaders + uint64_t { i } * sectionHeaderSize;
+        if (ReadWord(header + 4) != SectionTypeSymbolTable)
+            continue;
+
+        uint32_t const link = ReadWord(header + 24);
+        if (link >= numSectionHeaders)
+            return CannotRead { FileReadError::Type::InvalidFormat };
+
+        uint8_t const* stringTable = bytes + sectionHeaders + uint64_t { link } * sectionHeaderSize;
+        if (!ReadSymbolTable(bytes, size, header, stringTable, rtn.symbols))
+            return CannotRead { FileReadError::Type::InvalidFormat };
+    }
+
+    return rtn;
+}
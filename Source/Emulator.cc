@@ -3,9 +3,39 @@
 
 #include <pip-mips-emu/Emulator.hh>
 
+#include <cstring>
+#include <stdexcept>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#    include <cstdlib>
+#    include <cxxabi.h>
+#endif
+
 namespace
 {
 
+template <typename Component>
+std::string GetClassName(Component const& component)
+{
+    char const* name = typeid(component).name();
+#if defined(__GNUG__)
+    int   status    = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled)
+    {
+        std::string rtn { demangled };
+        std::free(demangled);
+        return rtn;
+    }
+#elif defined(_MSC_VER)
+    // MSVC prefixes the names with "class " or "struct "
+    if (char const* space = std::strchr(name, ' '))
+        name = space + 1;
+#endif
+    return name;
+}
+
 std::vector<DatapathPtr>
 FilterDatapath(std::vector<std::pair<DatapathPtr, TickTockType>>&& datapaths, TickTockType target)
 {
@@ -18,43 +48,6 @@ FilterDatapath(std::vector<std::pair<DatapathPtr, TickTockType>>&& datapaths, Ti
     return rtn;
 }
 
-void ApplyDeltas(Memory&                                memory,
-                 std::vector<uint16_t> const&           controls,
-                 std::vector<std::vector<Delta>> const& deltaLists)
-{
-    for (auto const& deltaList : deltaLists)
-    {
-        for (auto const& delta : deltaList)
-        {
-            switch (delta.type)
-            {
-            case Delta::Type::Register:
-            {
-                memory.SetRegister(delta.target, delta.value);
-                break;
-            }
-            case Delta::Type::Conditioned:
-            {
-                if (controls[delta.signal] == delta.condition)
-                    memory.SetRegister(delta.target, delta.value);
-                break;
-            }
-            case Delta::Type::MemoryWord:
-            {
-                memory.SetWord(Address::MakeFromWord(delta.target), delta.value);
-                break;
-            }
-            case Delta::Type::MemoryByte:
-            {
-                memory.SetByte(Address::MakeFromWord(delta.target),
-                               static_cast<uint8_t>(delta.value));
-                break;
-            }
-            }
-        }
-    }
-}
-
 }
 
 Emulator::Emulator(std::vector<std::pair<DatapathPtr, TickTockType>>&& datapaths,
@@ -72,42 +65,49 @@ Emulator::Emulator(std::vector<std::pair<DatapathPtr, TickTockType>>&& datapaths
     _controls(_namedSignals.size(), 0)
 {}
 
-TickTockResult Emulator::TickTock(Memory& memory, uint32_t& num_instr) noexcept
+std::vector<std::string> Emulator::GetControllerNames() const
 {
-    if (IsTerminated(memory))
-        return TickTockResult::AlreadyTerminated;
-
-    try
-    {
-        std::fill(_controls.begin(), _controls.end(), 0);
-        for (auto const& controller : _controllers)
-        {
-            for (auto const& control : controller->Execute(memory))
-                _controls[control.signal] = control.value;
-        }
-
-        std::vector<std::vector<Delta>> tickDeltas;
-        for (auto const& datapath : _tickDatapaths) tickDeltas.push_back(datapath->Execute(memory));
+    std::vector<std::string> rtn;
+    for (auto const& controller : _controllers) rtn.push_back(GetClassName(*controller));
+    return rtn;
+}
 
-        ApplyDeltas(memory, _controls, tickDeltas);
+std::string Emulator::GetHandlerName() const
+{
+    return GetClassName(*_handler);
+}
 
-        std::vector<std::vector<Delta>> tockDeltas;
-        for (auto const& datapath : _datapaths) tockDeltas.push_back(datapath->Execute(memory));
-        for (auto const& datapath : _tockDatapaths) tockDeltas.push_back(datapath->Execute(memory));
+std::vector<std::string> Emulator::GetDatapathNames() const
+{
+    std::vector<std::string> rtn;
+    for (auto const* datapaths : { &_tickDatapaths, &_datapaths, &_tockDatapaths })
+    {
+        for (auto const& datapath : *datapaths) rtn.push_back(GetClassName(*datapath));
+    }
+    return rtn;
+}
 
-        ApplyDeltas(memory, _controls, tockDeltas);
+uint32_t Emulator::FindRegister(char const* name) const
+{
+    auto it = _namedRegisters.find(name);
+    if (it == _namedRegisters.end())
+        throw std::invalid_argument { "The emulator does not have the default pipeline" };
+    return it->second;
+}
 
-        num_instr += _handler->CalcNumInstructions(memory);
+uint32_t Emulator::FindSignal(char const* name) const
+{
+    auto it = _namedSignals.find(name);
+    if (it == _namedSignals.end())
+        throw std::invalid_argument { "The emulator does not have the default pipeline" };
+    return it->second;
+}
 
-        return TickTockResult::Success;
-    }
-    catch (std::out_of_range const&)
-    {
-        return TickTockResult::MemoryOutOfRange;
-    }
-    catch (...)
+void Emulator::SetAccessLog(std::vector<StageAccess>* accessLog) noexcept
+{
+    for (auto* datapaths : { &_tickDatapaths, &_datapaths, &_tockDatapaths })
     {
-        return TickTockResult::UnknownError;
+        for (auto& datapath : *datapaths) datapath->SetAccessLog(accessLog);
     }
 }
 
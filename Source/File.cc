@@ -2,38 +2,314 @@
 // Licensed under the MIT License.
 
 #include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/Elf.hh>
 #include <pip-mips-emu/File.hh>
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <optional>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define PIP_MIPS_EMU_MMAP
+#endif
 
 namespace fs = std::filesystem;
 
 namespace
 {
 
-std::vector<uint8_t> MakeBytesFromWords(std::vector<uint32_t>::iterator begin,
-                                        std::vector<uint32_t>::iterator end)
+/// <summary>
+/// Size of the chunks read from the stream at once
+/// </summary>
+constexpr size_t ChunkSize = 1 << 16;
+
+/// <summary>
+/// Upper bound of the bytes reserved per segment from the header, so that a corrupted header does
+/// not make the reader allocate gigabytes up front
+/// </summary>
+constexpr size_t MaxReservedSegmentSize = 1 << 26;
+
+constexpr bool IsSpace(char c) noexcept
 {
-    size_t numBytes { static_cast<size_t>(std::distance(begin, end) * 4) };
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+/// <summary>
+/// Distributes words to the segments as they are parsed.
+/// </summary>
+class SegmentBuilder
+{
+  private:
+    std::vector<uint8_t> _text, _data;
+    uint32_t             _textSize, _dataSize;
+    uint64_t             _numWords;
+
+  public:
+    SegmentBuilder() noexcept : _textSize { 0 }, _dataSize { 0 }, _numWords { 0 } {}
+
+  public:
+    void Add(uint32_t word)
+    {
+        if (_numWords == 0)
+        {
+            _textSize = word;
+        }
+        else if (_numWords == 1)
+        {
+            _dataSize = word;
+            _text.reserve(std::min(static_cast<size_t>(_textSize), MaxReservedSegmentSize));
+            _data.reserve(std::min(static_cast<size_t>(_dataSize), MaxReservedSegmentSize));
+        }
+        else if (_text.size() + 4 <= _textSize)
+        {
+            Append(_text, word);
+        }
+        else if (_data.size() + 4 <= _dataSize)
+        {
+            Append(_data, word);
+        }
+
+        // Words which do not fit in the segments are only counted
+        ++_numWords;
+    }
+
+    FileReadResult Finish()
+    {
+        if (_numWords < 2)
+            return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
 
-    std::vector<uint8_t> rtn(numBytes, 0);
+        if (_textSize % 4 != 0 || _dataSize % 4 != 0)
+            return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
 
-    auto rtnIt = rtn.begin();
-    for (auto it = begin; it != end; ++it)
+        if (static_cast<uint64_t>(_textSize) + _dataSize != 4 * (_numWords - 2))
+            return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+
+        return CanRead { std::move(_text), std::move(_data), Address::MakeText(0), {} };
+    }
+
+  private:
+    static void Append(std::vector<uint8_t>& segment, uint32_t word)
     {
-        uint32_t word = *it;
         // MIPS uses big-endian
-        *(rtnIt++) = static_cast<uint8_t>((word & 0xFF000000) >> 24);
-        *(rtnIt++) = static_cast<uint8_t>((word & 0x00FF0000) >> 16);
-        *(rtnIt++) = static_cast<uint8_t>((word & 0x0000FF00) >> 8);
-        *(rtnIt++) = static_cast<uint8_t>((word & 0x000000FF) >> 0);
+        uint8_t const bytes[] {
+            static_cast<uint8_t>((word & 0xFF000000) >> 24),
+            static_cast<uint8_t>((word & 0x00FF0000) >> 16),
+            static_cast<uint8_t>((word & 0x0000FF00) >> 8),
+            static_cast<uint8_t>((word & 0x000000FF) >> 0),
+        };
+        segment.insert(segment.end(), std::begin(bytes), std::end(bytes));
+    }
+};
+
+/// <summary>
+/// Parses a line and adds its word to the builder. Returns <c>false</c> if the line is neither a
+/// word nor blank.
+/// </summary>
+bool ParseLine(char const* begin, char const* end, SegmentBuilder& builder)
+{
+    uint32_t value;
+    if (ParseWord(begin, end, value))
+    {
+        builder.Add(value);
+        return true;
+    }
+
+    return std::all_of(begin, end, IsSpace);
+}
+
+/// <summary>
+/// Splits chunks of a text executable into lines and parses them.
+/// </summary>
+class TextReader
+{
+  private:
+    SegmentBuilder _builder;
+
+    // The beginning of a line which spans multiple chunks
+    std::string _partialLine;
+
+  public:
+    /// <summary>
+    /// Parses the lines ending in the given chunk. Returns <c>false</c> if any of them is invalid.
+    /// </summary>
+    bool Consume(char const* it, char const* end)
+    {
+        while (it != end)
+        {
+            char const* newline = static_cast<char const*>(std::memchr(it, '\n', end - it));
+            if (newline == nullptr)
+            {
+                _partialLine.append(it, end);
+                break;
+            }
+
+            bool isValid;
+            if (_partialLine.empty())
+            {
+                isValid = ParseLine(it, newline, _builder);
+            }
+            else
+            {
+                _partialLine.append(it, newline);
+
+                char const* lineBegin = _partialLine.data();
+                isValid = ParseLine(lineBegin, lineBegin + _partialLine.size(), _builder);
+                _partialLine.clear();
+            }
+
+            if (!isValid)
+                return false;
+
+            it = newline + 1;
+        }
+
+        return true;
     }
 
-    return rtn;
+    FileReadResult Finish()
+    {
+        char const* lineBegin = _partialLine.data();
+        if (!ParseLine(lineBegin, lineBegin + _partialLine.size(), _builder))
+            return CannotRead { FileReadError::Type::InvalidFormat };
+
+        return _builder.Finish();
+    }
+};
+
+uint32_t ReadBigEndianWord(uint8_t const* ptr) noexcept
+{
+    return static_cast<uint32_t>(ptr[0]) << 24 | static_cast<uint32_t>(ptr[1]) << 16
+           | static_cast<uint32_t>(ptr[2]) << 8 | static_cast<uint32_t>(ptr[3]) << 0;
+}
+
+void WriteBigEndianWord(uint32_t word, std::ostream& os)
+{
+    char const bytes[] {
+        static_cast<char>((word & 0xFF000000) >> 24),
+        static_cast<char>((word & 0x00FF0000) >> 16),
+        static_cast<char>((word & 0x0000FF00) >> 8),
+        static_cast<char>((word & 0x000000FF) >> 0),
+    };
+    os.write(bytes, sizeof(bytes));
 }
 
+bool HasMagic(char const* bytes, size_t size, char const (&magic)[4]) noexcept
+{
+    return size >= sizeof(magic) && std::memcmp(bytes, magic, sizeof(magic)) == 0;
+}
+
+/// <summary>
+/// Returns whether the given bytes begin with the magic number of a format which is read from
+/// bytes in memory instead of being parsed line by line.
+/// </summary>
+bool HasMappableFileMagic(char const* bytes, size_t size) noexcept
+{
+    return HasMagic(bytes, size, BinaryFileMagic) || HasMagic(bytes, size, ElfFileMagic);
+}
+
+/// <summary>
+/// Reads a binary executable, including its magic number, from the given bytes.
+/// </summary>
+FileReadResult ReadBinaryFile(uint8_t const* bytes, size_t size)
+{
+    if (size < BinaryFileHeaderSize)
+        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+
+    uint32_t const version    = ReadBigEndianWord(bytes + 4);
+    uint32_t const textSize   = ReadBigEndianWord(bytes + 8);
+    uint32_t const dataSize   = ReadBigEndianWord(bytes + 12);
+    uint32_t const entryPoint = ReadBigEndianWord(bytes + 16);
+
+    if (version != BinaryFileVersion)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    if (textSize % 4 != 0 || dataSize % 4 != 0)
+        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+
+    if (static_cast<uint64_t>(textSize) + dataSize != size - BinaryFileHeaderSize)
+        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+
+    uint32_t const textBase = Address::MakeText(0);
+    if (entryPoint % 4 != 0 || entryPoint < textBase || entryPoint - textBase > textSize)
+        return CannotRead { FileReadError::Type::InvalidFormat };
+
+    uint8_t const* text = bytes + BinaryFileHeaderSize;
+    uint8_t const* data = text + textSize;
+    return CanRead {
+        std::vector<uint8_t>(text, text + textSize),
+        std::vector<uint8_t>(data, data + dataSize),
+        entryPoint,
+        {},
+    };
+}
+
+/// <summary>
+/// Reads a binary or ELF executable from the given bytes.
+/// </summary>
+FileReadResult ReadMappableFile(uint8_t const* bytes, size_t size)
+{
+    if (HasMagic(reinterpret_cast<char const*>(bytes), size, ElfFileMagic))
+        return ReadElfFile(bytes, size);
+    else
+        return ReadBinaryFile(bytes, size);
+}
+
+#if defined(PIP_MIPS_EMU_MMAP)
+/// <summary>
+/// Maps the given binary or ELF executable into the memory and reads it. The sections are copied
+/// out of the mapping into <c>CanRead</c>, so this only saves the copy through a stream buffer.
+/// Returns <c>std::nullopt</c> if the file is of another format or cannot be mapped.
+/// </summary>
+std::optional<FileReadResult> MapFile(fs::path const& path)
+{
+    int const fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return std::nullopt;
+
+    struct stat st;
+    char        magic[4];
+    if (fstat(fd, &st) != 0 || st.st_size <= 0
+        || pread(fd, magic, sizeof(magic), 0) != static_cast<ssize_t>(sizeof(magic))
+        || !HasMappableFileMagic(magic, sizeof(magic)))
+    {
+        close(fd);
+        return std::nullopt;
+    }
+
+    size_t const size = static_cast<size_t>(st.st_size);
+    void*        ptr  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return std::nullopt;
+
+    madvise(ptr, size, MADV_SEQUENTIAL);
+
+    FileReadResult result = ReadMappableFile(static_cast<uint8_t const*>(ptr), size);
+    munmap(ptr, size);
+    return result;
+}
+#endif
+
+}
+
+char const* FileReadError::GetMessage() const noexcept
+{
+    switch (type)
+    {
+    case FileReadError::Type::FileDoesNotExist: return "File does not exist";
+    case FileReadError::Type::GivenPathIsDirectory: return "File is directory";
+    case FileReadError::Type::InvalidFormat: return "Invalid file";
+    case FileReadError::Type::SectionSizeDoesNotMatch: return "Section size does not match";
+    }
+
+    return "Unknown file I/O error";
 }
 
 FileReadResult ReadFile(std::filesystem::path const& path)
@@ -41,7 +317,26 @@ FileReadResult ReadFile(std::filesystem::path const& path)
     if (fs::is_directory(path))
         return CannotRead { FileReadError::Type::GivenPathIsDirectory };
 
-    std::ifstream ifs { path };
+#if defined(PIP_MIPS_EMU_MMAP)
+    if (auto result = MapFile(path))
+        return std::move(result.value());
+#endif
+
+    std::ifstream ifs { path, std::ios::binary };
+    if (!ifs)
+        return CannotRead { FileReadError::Type::FileDoesNotExist };
+
+    char magic[4];
+    ifs.read(magic, sizeof(magic));
+    if (HasMappableFileMagic(magic, static_cast<size_t>(ifs.gcount())))
+    {
+        ifs.seekg(0);
+        return ReadFile(ifs);
+    }
+
+    // Text executables are read in the text mode so that line endings are translated
+    ifs.close();
+    ifs.open(path);
     if (!ifs)
         return CannotRead { FileReadError::Type::FileDoesNotExist };
 
@@ -50,36 +345,48 @@ FileReadResult ReadFile(std::filesystem::path const& path)
 
 FileReadResult ReadFile(std::istream& is)
 {
-    std::vector<uint32_t> words;
+    std::vector<char> buffer(ChunkSize);
 
-    std::string line;
-    uint32_t    value;
-    while (std::getline(is, line))
-    {
-        if (std::find_if(line.begin(), line.end(), [](char c) { return !isspace(c); })
-            == line.end())
-            continue;
+    char magic[4];
+    is.read(magic, sizeof(magic));
 
-        if (!ParseWord(std::addressof(line[0]), std::addressof(line[line.size()]), value))
-            return CannotRead { FileReadError::Type::InvalidFormat };
+    size_t const numMagicBytes = static_cast<size_t>(is.gcount());
+    if (HasMappableFileMagic(magic, numMagicBytes))
+    {
+        std::vector<uint8_t> bytes(std::begin(magic), std::end(magic));
+        while (is)
+        {
+            is.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            bytes.insert(bytes.end(), buffer.data(), buffer.data() + is.gcount());
+        }
 
-        words.push_back(value);
+        return ReadMappableFile(bytes.data(), bytes.size());
     }
 
-    if (words.size() < 2)
-        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+    TextReader reader;
+    if (!reader.Consume(magic, magic + numMagicBytes))
+        return CannotRead { FileReadError::Type::InvalidFormat };
 
-    if (words[0] % 4 != 0)
-        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+    while (is)
+    {
+        is.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!reader.Consume(buffer.data(), buffer.data() + is.gcount()))
+            return CannotRead { FileReadError::Type::InvalidFormat };
+    }
 
-    if (words[1] % 4 != 0)
-        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+    return reader.Finish();
+}
 
-    if (words[0] + words[1] != 4 * static_cast<uint32_t>(words.size() - 2))
-        return CannotRead { FileReadError::Type::SectionSizeDoesNotMatch };
+void WriteBinaryFile(CanRead const& file, std::ostream& os)
+{
+    os.write(BinaryFileMagic, sizeof(BinaryFileMagic));
+    WriteBigEndianWord(BinaryFileVersion, os);
+    WriteBigEndianWord(static_cast<uint32_t>(file.text.size()), os);
+    WriteBigEndianWord(static_cast<uint32_t>(file.data.size()), os);
+    WriteBigEndianWord(file.entryPoint, os);
 
-    return CanRead {
-        MakeBytesFromWords(words.begin() + 2, words.begin() + 2 + (words[0] / 4)),
-        MakeBytesFromWords(words.end() - (words[1] / 4), words.end()),
-    };
-}
\ No newline at end of file
+    os.write(reinterpret_cast<char const*>(file.text.data()),
+             static_cast<std::streamsize>(file.text.size()));
+    os.write(reinterpret_cast<char const*>(file.data.data()),
+             static_cast<std::streamsize>(file.data.size()));
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2021 Chanjung Kim (paxbun). All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/File.hh>
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Converts an executable into the binary format.
+// Usage: hex2bin <input> <output>
+int main(int argc, char* argv[])
+{
+    try
+    {
+        if (argc != 3)
+            throw std::runtime_error { "Usage: hex2bin <input> <output>" };
+
+        FileReadResult fileResult { ReadFile(argv[1]) };
+        if (std::holds_alternative<CannotRead>(fileResult))
+            throw std::runtime_error { std::get<CannotRead>(fileResult).error.GetMessage() };
+
+        std::ofstream ofs { argv[2], std::ios::binary };
+        if (!ofs)
+            throw std::runtime_error { "Cannot open the output file" };
+
+        WriteBinaryFile(std::get<CanRead>(fileResult), ofs);
+        if (!ofs.flush())
+            throw std::runtime_error { "Cannot write the output file" };
+
+        return 0;
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+}
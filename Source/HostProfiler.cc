@@ -0,0 +1,133 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/HostProfiler.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+
+/// <summary>
+/// Number of the pairs of timer reads used to measure the cost of reading the timer
+/// </summary>
+constexpr size_t NumCalibrations = 1000;
+
+std::vector<HostProfileEntry> MakeEntries(std::vector<std::string> names)
+{
+    std::vector<HostProfileEntry> rtn(names.size());
+    for (size_t i = 0; i < names.size(); ++i) rtn[i].name = std::move(names[i]);
+    return rtn;
+}
+
+uint64_t MeasureTimerTicks() noexcept
+{
+    // The minimum is what a sample of an empty function measures
+    uint64_t minimum = UINT64_MAX;
+    for (size_t i = 0; i < NumCalibrations; ++i)
+    {
+        uint64_t const begin = ReadHostTicks();
+        minimum              = std::min(minimum, ReadHostTicks() - begin);
+    }
+    return minimum;
+}
+
+}
+
+HostProfiler::HostProfiler(Emulator const& emulator) :
+    _controllers { MakeEntries(emulator.GetControllerNames()) },
+    _datapaths { MakeEntries(emulator.GetDatapathNames()) },
+    _applyDeltas {},
+    _handler {},
+    _timerTicks { MeasureTimerTicks() },
+    _cycles { 0 }
+{
+    _applyDeltas[0].name = "ApplyDeltas (before signals)";
+    _applyDeltas[1].name = "ApplyDeltas (after signals)";
+
+    std::string const handler = emulator.GetHandlerName();
+    _handler[0].name          = handler + "::IsTerminated";
+    _handler[1].name          = handler + "::CalcNumInstructions";
+    _handler[2].name          = handler + "::GetPCs";
+}
+
+std::vector<HostProfileEntry> HostProfiler::GetEntries(HostPhase phase) const
+{
+    switch (phase)
+    {
+    case HostPhase::Controller: return _controllers;
+    case HostPhase::Datapath: return _datapaths;
+    case HostPhase::ApplyDeltas: return { _applyDeltas.begin(), _applyDeltas.end() };
+    case HostPhase::Handler: return { _handler.begin(), _handler.end() };
+    }
+    return {};
+}
+
+void HostProfiler::OnHostTicks(HostPhase phase, size_t index, uint64_t ticks) noexcept
+{
+    HostProfileEntry* entry = nullptr;
+    switch (phase)
+    {
+    case HostPhase::Controller: entry = &_controllers[index]; break;
+    case HostPhase::Datapath: entry = &_datapaths[index]; break;
+    case HostPhase::ApplyDeltas: entry = &_applyDeltas[index]; break;
+    case HostPhase::Handler: entry = &_handler[index]; break;
+    }
+
+    entry->ticks += ticks > _timerTicks ? ticks - _timerTicks : 0;
+    ++entry->samples;
+}
+
+void HostProfiler::WriteReport(std::ostream& stream) const
+{
+    std::vector<HostProfileEntry> merged;
+    for (auto phase :
+         { HostPhase::Controller, HostPhase::Datapath, HostPhase::ApplyDeltas, HostPhase::Handler })
+    {
+        for (auto const& entry : GetEntries(phase))
+        {
+            auto it = std::find_if(merged.begin(), merged.end(), [&](auto const& mergedEntry) {
+                return mergedEntry.name == entry.name;
+            });
+            if (it == merged.end())
+            {
+                merged.push_back(entry);
+                continue;
+            }
+            it->ticks += entry.ticks;
+            it->samples += entry.samples;
+        }
+    }
+
+    std::stable_sort(merged.begin(), merged.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.ticks > rhs.ticks;
+    });
+
+    uint64_t total = 0;
+    for (auto const& entry : merged) total += entry.ticks;
+
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    stream << "Host ticks of " << _cycles << " cycles (" << _timerTicks
+           << " ticks per sample subtracted):\n";
+    stream << std::setw(14) << "ticks" << std::setw(8) << "%" << std::setw(12) << "per cycle"
+           << "  component\n";
+    for (auto const& entry : merged)
+    {
+        if (!entry.samples)
+            continue;
+
+        double const percentage = total ? 100.0 * static_cast<double>(entry.ticks) / total : 0.0;
+        double const perCycle   = _cycles ? static_cast<double>(entry.ticks) / _cycles : 0.0;
+
+        stream << std::setw(14) << entry.ticks << std::setw(8) << percentage << std::setw(12)
+               << perCycle << "  " << entry.name << '\n';
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
@@ -1,9 +1,12 @@
 // Copyright (c) 2021 Chanjung Kim. All rights reserved.
 // Licensed under the MIT License.
 
+#include <pip-mips-emu/Dump.hh>
 #include <pip-mips-emu/Formats.hh>
 #include <pip-mips-emu/Implementations.hh>
 
+#include <algorithm>
+
 namespace
 {
 
@@ -23,6 +26,13 @@ constexpr uint32_t SignExtend(uint32_t value, uint32_t numBits) noexcept
 
 }
 
+// Latches keep their values while the pipeline waits for the memory.
+#define LATCH(registerName, value)                                                                 \
+    Delta::Unless((registerName), (value), pipelineState, PipelineState::MemoryStalled)
+
+#define FORWARD_LATCH(from, to)                                                                    \
+    FORWARD_REGISTER_UNLESS(from, to, pipelineState, PipelineState::MemoryStalled)
+
 // ------------------------------------- DefaultHandler  --------------------------------------- //
 
 #pragma region DefaultHandler
@@ -65,54 +75,39 @@ HANDLER_CALC_NUM_INSTRS(DefaultHandler)
     return memory.GetRegister(WB_PC) && memory.GetRegister(WB_Instr);
 }
 
-HANDLER_DUMP_PCS(DefaultHandler)
+HANDLER_GET_PCS(DefaultHandler)
 {
-    std::ios_base::fmtflags flags = stream.flags();
-
     uint32_t const registers[] = { IF_ID_PC, ID_EX_PC, EX_MEM_PC, MEM_WB_PC, WB_PC };
     uint32_t const instructions[]
         = { IF_ID_Instr, ID_EX_Instr, EX_MEM_Instr, MEM_WB_Instr, WB_Instr };
     uint32_t const maxPCValue = Address::MakeText(memory.GetTextSize());
 
-    stream << "Current pipeline PC state:\n";
-
-    for (int i = 0; i < 5; ++i)
+    PCs rtn {};
+    for (uint32_t i = 0; i < NumStages; ++i)
     {
-        if (i == 0)
-            stream << '{';
-        else
-            stream << '|';
-
-        uint32_t const reg   = registers[i];
-        uint32_t const instr = instructions[i];
-
-        uint32_t const content = memory.GetRegister(reg);
-        if (content && memory.GetRegister(instr))
-            stream << "0x" << std::hex << std::min(content, maxPCValue);
+        uint32_t const content = memory.GetRegister(registers[i]);
+        if (content && memory.GetRegister(instructions[i]))
+            rtn[i] = std::min(content, maxPCValue);
     }
-    stream << "}\n";
 
-    stream.flags(flags);
+    return rtn;
 }
 
-HANDLER_DUMP_REGISTERS(DefaultHandler)
+HANDLER_DUMP_PCS(DefaultHandler)
 {
-    std::ios_base::fmtflags flags = stream.flags();
+    WritePCs(GetPCs(memory), stream);
+}
 
+HANDLER_DUMP_REGISTERS(DefaultHandler)
+{
     uint32_t const realPCValue = memory.GetRegister(Memory::PC);
     uint32_t const maxPCValue  = Address::MakeText(memory.GetTextSize());
 
-    stream << "Current register values:\n";
-    stream << "------------------------------------\n";
-    stream << "PC: 0x" << std::hex << std::min(realPCValue, maxPCValue) << '\n';
-    stream << "Registers:\n";
-
-    for (uint32_t idx = 0; idx < Memory::PC; ++idx)
-    {
-        stream << "R" << std::dec << idx << ": 0x" << std::hex << memory.GetRegister(idx) << '\n';
-    }
+    uint32_t registers[NumDumpedRegisters];
+    for (uint32_t idx = 0; idx < NumDumpedRegisters; ++idx)
+        registers[idx] = memory.GetRegister(idx);
 
-    stream.flags(flags);
+    WriteRegisters(std::min(realPCValue, maxPCValue), registers, stream);
 }
 
 HANDLER_DUMP_MEMORY(DefaultHandler)
@@ -120,19 +115,21 @@ HANDLER_DUMP_MEMORY(DefaultHandler)
     if (static_cast<uint32_t>(range.begin) > static_cast<uint32_t>(range.end))
         throw std::invalid_argument { "invalid memory range" };
 
-    std::ios_base::fmtflags flags = stream.flags();
-
-    stream << std::hex;
-    stream << "Memory content [" << range.begin << ".." << range.end << "]:\n";
-    stream << "------------------------------------\n";
+    // The whole range is formatted into one buffer, so the stream is written in large blocks
+    TextBuffer buffer { stream };
+    WriteMemoryHeader(range, buffer);
 
-    for (uint32_t current = range.begin; current <= range.end; current += 4)
+    uint32_t words[256];
+    for (uint64_t current = range.begin; current <= range.end; current += sizeof(words))
     {
-        Address address = Address::MakeFromWord(current);
-        stream << address << ": 0x" << memory.GetWord(address) << '\n';
-    }
+        // Chunks may cross the base of the data segment, as ReadMemoryWords splits them
+        uint64_t const last = std::min<uint64_t>(range.end, current + sizeof(words) - 4);
+        Range const    chunk { Address::MakeFromWord(static_cast<uint32_t>(current)),
+                               Address::MakeFromWord(static_cast<uint32_t>(last)) };
 
-    stream.flags(flags);
+        ReadMemoryWords(memory, chunk, words);
+        WriteMemoryWords(chunk.begin, words, static_cast<size_t>((last - current) / 4 + 1), buffer);
+    }
 }
 
 #pragma endregion
@@ -151,6 +148,9 @@ CONTROLLER_INIT(ATPPipelineStateController)
     REGISTER_READ(ID_EX_MemRead);
     REGISTER_READ(ID_EX_Reg2);
 
+    REGISTER_READ(IF_StallCycles);
+    REGISTER_READ(MEM_StallCycles);
+
     MAKE_SIGNAL(nextPCType);
     MAKE_SIGNAL(pipelineState);
 }
@@ -159,6 +159,14 @@ CONTROLLER_EXEC(ATPPipelineStateController)
 {
     DEFINE_CONTROLS();
 
+    if (memory.GetRegister(IF_StallCycles) || memory.GetRegister(MEM_StallCycles))
+    {
+        // cache miss
+        ADD_CONTROL((Control::New(nextPCType, NextPCType::NotMutated)));
+        ADD_CONTROL((Control::New(pipelineState, PipelineState::MemoryStalled)));
+        RETURN_CONTROLS();
+    }
+
     uint32_t const ex_mem_aluResult = memory.GetRegister(EX_MEM_ALUResult);
     uint32_t const ex_mem_instr     = memory.GetRegister(EX_MEM_Instr);
     uint32_t const ex_mem_operation = (ex_mem_instr >> 26) & 0b111111;
@@ -222,6 +230,9 @@ CONTROLLER_INIT(ANTPPipelineStateController)
     REGISTER_READ(ID_EX_MemRead);
     REGISTER_READ(ID_EX_Reg2);
 
+    REGISTER_READ(IF_StallCycles);
+    REGISTER_READ(MEM_StallCycles);
+
     MAKE_SIGNAL(nextPCType);
     MAKE_SIGNAL(pipelineState);
 }
@@ -230,6 +241,14 @@ CONTROLLER_EXEC(ANTPPipelineStateController)
 {
     DEFINE_CONTROLS();
 
+    if (memory.GetRegister(IF_StallCycles) || memory.GetRegister(MEM_StallCycles))
+    {
+        // cache miss
+        ADD_CONTROL((Control::New(nextPCType, NextPCType::NotMutated)));
+        ADD_CONTROL((Control::New(pipelineState, PipelineState::MemoryStalled)));
+        RETURN_CONTROLS();
+    }
+
     uint32_t const ex_mem_aluResult = memory.GetRegister(EX_MEM_ALUResult);
     uint32_t const ex_mem_instr     = memory.GetRegister(EX_MEM_Instr);
     uint32_t const ex_mem_operation = (ex_mem_instr >> 26) & 0b111111;
@@ -274,14 +293,21 @@ CONTROLLER_EXEC(ANTPPipelineStateController)
 
 #pragma region InstructionFetch
 
+InstructionFetch::InstructionFetch(MemoryLevelPtr memoryLevel) :
+    _memoryLevel { std::move(memoryLevel) }
+{}
+
 DATAPATH_INIT(InstructionFetch)
 {
     REGISTER_READ(PC);
+    REGISTER_READ(MEM_StallCycles);
 
     REGISTER_WRITE(IF_ID_PC);
     REGISTER_WRITE(IF_ID_NextPC);
     REGISTER_WRITE(IF_ID_Instr);
 
+    REGISTER_READ_WRITE(IF_StallCycles);
+
     SIGNAL(nextPCType);
     SIGNAL(pipelineState);
 }
@@ -290,10 +316,32 @@ DATAPATH_EXEC(InstructionFetch)
 {
     DEFINE_DELTAS();
 
+    uint32_t const stallCycles = memory.GetRegister(IF_StallCycles);
+    if (stallCycles || memory.GetRegister(MEM_StallCycles))
+    {
+        // Wait until all misses are served
+        if (stallCycles)
+            ADD_DELTA((Delta::Register(IF_StallCycles, stallCycles - 1)));
+        RETURN_DELTAS();
+    }
+
     uint32_t const pcValue    = memory.GetRegister(PC);
     uint32_t const newPCValue = pcValue + 4;
 
-    uint32_t const instruction = memory.GetWord(Address::MakeFromWord(pcValue));
+    Address const  address     = Address::MakeFromWord(pcValue);
+    uint32_t const instruction = memory.GetWord(address);
+
+    // Fetching beyond the text segment only happens while the pipeline is being drained
+    if (address.base == Address::BaseType::Text && address.offset < memory.GetTextSize())
+    {
+        ReportAccess(AccessKind::Fetch, pcValue, pcValue, 4);
+        if (_memoryLevel)
+        {
+            uint32_t const penalty = _memoryLevel->Access(pcValue, AccessType::Read);
+            if (penalty)
+                ADD_DELTA((Delta::Register(IF_StallCycles, penalty)));
+        }
+    }
 
     ADD_DELTA((Delta::Conditioned(PC, newPCValue, nextPCType, NextPCType::AdvancedPC)));
 
@@ -353,8 +401,8 @@ DATAPATH_EXEC(InstructionDecode)
 {
     DEFINE_DELTAS();
 
-    FORWARD_REGISTER(IF_ID_PC, ID_EX_PC);
-    FORWARD_REGISTER(IF_ID_NextPC, ID_EX_NextPC);
+    FORWARD_LATCH(IF_ID_PC, ID_EX_PC);
+    FORWARD_LATCH(IF_ID_NextPC, ID_EX_NextPC);
 
     uint32_t const instruction = memory.GetRegister(IF_ID_Instr);
     ADD_DELTA((Delta::Conditioned(ID_EX_Instr, instruction, pipelineState, PipelineState::Normal)));
@@ -438,16 +486,16 @@ DATAPATH_EXEC(InstructionDecode)
     ADD_DELTA((Delta::Conditioned(ID_EX_MemWrite, 0, pipelineState, PipelineState::Flushed3)));
     ADD_DELTA((Delta::Conditioned(ID_EX_MemRead, 0, pipelineState, PipelineState::Flushed3)));
 
-    ADD_DELTA((Delta::Register(ID_EX_Reg1Value, register1Value)));
-    ADD_DELTA((Delta::Register(ID_EX_Reg2Value, register2Value)));
+    ADD_DELTA((LATCH(ID_EX_Reg1Value, register1Value)));
+    ADD_DELTA((LATCH(ID_EX_Reg2Value, register2Value)));
 
-    ADD_DELTA((Delta::Register(ID_EX_Imm, immediate)));
-    ADD_DELTA((Delta::Register(ID_EX_Reg1, register1)));
-    ADD_DELTA((Delta::Register(ID_EX_Reg2, register2)));
-    ADD_DELTA((Delta::Register(ID_EX_Reg3, register3)));
+    ADD_DELTA((LATCH(ID_EX_Imm, immediate)));
+    ADD_DELTA((LATCH(ID_EX_Reg1, register1)));
+    ADD_DELTA((LATCH(ID_EX_Reg2, register2)));
+    ADD_DELTA((LATCH(ID_EX_Reg3, register3)));
 
-    ADD_DELTA((Delta::Register(ID_EX_RAWrite, raWrite)));
-    ADD_DELTA((Delta::Register(ID_EX_RAValue, raValue)));
+    ADD_DELTA((LATCH(ID_EX_RAWrite, raWrite)));
+    ADD_DELTA((LATCH(ID_EX_RAValue, raValue)));
 
     RETURN_DELTAS();
 }
@@ -511,8 +559,8 @@ DATAPATH_EXEC(Execution)
 {
     DEFINE_DELTAS();
 
-    FORWARD_REGISTER(ID_EX_PC, EX_MEM_PC);
-    FORWARD_REGISTER(ID_EX_NextPC, EX_MEM_NextPC);
+    FORWARD_LATCH(ID_EX_PC, EX_MEM_PC);
+    FORWARD_LATCH(ID_EX_NextPC, EX_MEM_NextPC);
 
     uint32_t const instruction = memory.GetRegister(ID_EX_Instr);
     uint32_t const regWrite    = memory.GetRegister(ID_EX_RegWrite);
@@ -548,10 +596,10 @@ DATAPATH_EXEC(Execution)
     ADD_DELTA((Delta::Conditioned(EX_MEM_MemWrite, 0, pipelineState, PipelineState::Flushed3)));
     ADD_DELTA((Delta::Conditioned(EX_MEM_MemRead, 0, pipelineState, PipelineState::Flushed3)));
 
-    FORWARD_REGISTER(ID_EX_Reg2, EX_MEM_Reg2);
+    FORWARD_LATCH(ID_EX_Reg2, EX_MEM_Reg2);
 
-    FORWARD_REGISTER(ID_EX_RAWrite, EX_MEM_RAWrite);
-    FORWARD_REGISTER(ID_EX_RAValue, EX_MEM_RAValue);
+    FORWARD_LATCH(ID_EX_RAWrite, EX_MEM_RAWrite);
+    FORWARD_LATCH(ID_EX_RAValue, EX_MEM_RAValue);
 
     uint32_t const operation = (instruction >> 26) & 0b111111;
     uint32_t const register1 = memory.GetRegister(ID_EX_Reg1);
@@ -581,7 +629,7 @@ DATAPATH_EXEC(Execution)
             source1Value = ex_mem_aluResult;
         if (ex_mem_destReg == register2)
             source2Value = ex_mem_aluResult;
-        ADD_DELTA(Delta::Register(EX_MEM_Reg2Value, source2Value));
+        ADD_DELTA(LATCH(EX_MEM_Reg2Value, source2Value));
     }
     // MEM/WB to EX forwarding
     else if (mem_wb_regWrite && mem_wb_destReg
@@ -597,7 +645,7 @@ DATAPATH_EXEC(Execution)
             source1Value = value;
         if (mem_wb_destReg == register2)
             source2Value = value;
-        ADD_DELTA(Delta::Register(EX_MEM_Reg2Value, source2Value));
+        ADD_DELTA(LATCH(EX_MEM_Reg2Value, source2Value));
     }
     // MEM/WB to EX forwarding (RA)
     else if (mem_wb_raWrite)
@@ -607,11 +655,11 @@ DATAPATH_EXEC(Execution)
             source1Value = value;
         if (register2 == Memory::RA)
             source2Value = value;
-        ADD_DELTA(Delta::Register(EX_MEM_Reg2Value, source2Value));
+        ADD_DELTA(LATCH(EX_MEM_Reg2Value, source2Value));
     }
     else
     {
-        FORWARD_REGISTER(ID_EX_Reg2Value, EX_MEM_Reg2Value);
+        FORWARD_LATCH(ID_EX_Reg2Value, EX_MEM_Reg2Value);
     }
 
     uint32_t destinationValue = 0;
@@ -686,8 +734,8 @@ DATAPATH_EXEC(Execution)
     {
         destinationValue = source1Value + SignExtend(immediate, 16);
     }
-    ADD_DELTA((Delta::Register(EX_MEM_ALUResult, destinationValue)));
-    ADD_DELTA((Delta::Register(EX_MEM_DestReg, destination)));
+    ADD_DELTA((LATCH(EX_MEM_ALUResult, destinationValue)));
+    ADD_DELTA((LATCH(EX_MEM_DestReg, destination)));
 
     RETURN_DELTAS();
 }
@@ -698,6 +746,8 @@ DATAPATH_EXEC(Execution)
 
 #pragma region MemoryAccess
 
+MemoryAccess::MemoryAccess(MemoryLevelPtr memoryLevel) : _memoryLevel { std::move(memoryLevel) } {}
+
 DATAPATH_INIT(MemoryAccess)
 {
     // Registers to read
@@ -718,6 +768,8 @@ DATAPATH_INIT(MemoryAccess)
     REGISTER_READ(EX_MEM_RAWrite);
     REGISTER_READ(EX_MEM_RAValue);
 
+    REGISTER_READ(IF_StallCycles);
+
     // Registers to forward
     REGISTER_WRITE(MEM_WB_PC);
     REGISTER_WRITE(MEM_WB_Instr);
@@ -736,6 +788,8 @@ DATAPATH_INIT(MemoryAccess)
 
     REGISTER_WRITE(PC);
 
+    REGISTER_READ_WRITE(MEM_StallCycles);
+
     // Signals
     SIGNAL(nextPCType);
 }
@@ -744,6 +798,18 @@ DATAPATH_EXEC(MemoryAccess)
 {
     DEFINE_DELTAS();
 
+    if (_memoryLevel)
+        _memoryLevel->Tick();
+
+    uint32_t const stallCycles = memory.GetRegister(MEM_StallCycles);
+    if (stallCycles || memory.GetRegister(IF_StallCycles))
+    {
+        // Wait until all misses are served
+        if (stallCycles)
+            ADD_DELTA((Delta::Register(MEM_StallCycles, stallCycles - 1)));
+        RETURN_DELTAS();
+    }
+
     FORWARD_REGISTER(EX_MEM_PC, MEM_WB_PC);
     FORWARD_REGISTER(EX_MEM_Instr, MEM_WB_Instr);
 
@@ -774,6 +840,20 @@ DATAPATH_EXEC(MemoryAccess)
 
     uint32_t      readData = 0;
     Address const address  = Address::MakeFromWord(aluResult);
+    if (memoryRead || memoryWrite)
+    {
+        ReportAccess(memoryWrite ? AccessKind::Store : AccessKind::Load,
+                     memory.GetRegister(EX_MEM_PC),
+                     aluResult,
+                     (operation & 0b11) == 0b11 ? 4 : 1);
+        if (_memoryLevel)
+        {
+            uint32_t const penalty = _memoryLevel->Access(
+                aluResult, memoryWrite ? AccessType::Write : AccessType::Read);
+            if (penalty)
+                ADD_DELTA((Delta::Register(MEM_StallCycles, penalty)));
+        }
+    }
     if (memoryRead)
     {
         if ((operation & 0b11) == 0b11)
@@ -830,14 +910,19 @@ DATAPATH_INIT(WriteBack)
     REGISTER_WRITE(WB_Instr);
 
     REGISTER_WRITE(RA);
+
+    SIGNAL(pipelineState);
 }
 
 DATAPATH_EXEC(WriteBack)
 {
     DEFINE_DELTAS();
 
-    FORWARD_REGISTER(MEM_WB_PC, WB_PC);
-    FORWARD_REGISTER(MEM_WB_Instr, WB_Instr);
+    FORWARD_LATCH(MEM_WB_PC, WB_PC);
+    FORWARD_LATCH(MEM_WB_Instr, WB_Instr);
+
+    // The instruction in MEM/WB is written back once
+    ADD_DELTA((Delta::Conditioned(WB_Instr, 0, pipelineState, PipelineState::MemoryStalled)));
 
     uint32_t const instruction = memory.GetRegister(MEM_WB_Instr);
     uint32_t const regWrite    = memory.GetRegister(MEM_WB_RegWrite);
@@ -850,7 +935,7 @@ DATAPATH_EXEC(WriteBack)
 
     if (raWrite)
     {
-        ADD_DELTA((Delta::Register(RA, raValue)));
+        ADD_DELTA((LATCH(RA, raValue)));
     }
 
     if (regWrite)
@@ -860,7 +945,7 @@ DATAPATH_EXEC(WriteBack)
             destinationValue = readData;
         else
             destinationValue = aluResult;
-        ADD_DELTA((Delta::Register(destination, destinationValue)));
+        ADD_DELTA((LATCH(destination, destinationValue)));
     }
 
     RETURN_DELTAS();
@@ -0,0 +1,110 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/InstructionMix.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+double Percentage(uint64_t count, uint64_t total) noexcept
+{
+    return total ? 100.0 * static_cast<double>(count) / total : 0.0;
+}
+
+}
+
+InstructionMix::InstructionMix(Emulator const& emulator) :
+    _handler { *emulator.GetHandler() },
+    _wbInstr { emulator.FindRegister("WB_Instr") },
+    _counts {},
+    _takenBranches {},
+    _classCounts {},
+    _instructions { 0 }
+{}
+
+void InstructionMix::OnCycleEnd(Memory const& memory) noexcept
+{
+    if (!_handler.CalcNumInstructions(memory))
+        return;
+
+    uint32_t const instruction      = memory.GetRegister(_wbInstr);
+    size_t const   slot             = GetSlot(instruction);
+    auto const     instructionClass = Classify(instruction);
+
+    ++_instructions;
+    ++_counts[slot];
+    ++_classCounts[static_cast<size_t>(instructionClass)];
+
+    if (instructionClass == InstructionClass::Branch && IsBranchTaken(instruction, memory))
+        ++_takenBranches[slot];
+}
+
+void InstructionMix::WriteReport(std::ostream& stream) const
+{
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    std::vector<size_t> slots;
+    for (size_t slot = 0; slot < NumSlots; ++slot)
+    {
+        if (_counts[slot])
+            slots.push_back(slot);
+    }
+    std::stable_sort(slots.begin(), slots.end(), [&](size_t lhs, size_t rhs) {
+        return _counts[lhs] > _counts[rhs];
+    });
+
+    stream << "Instruction mix of " << _instructions << " committed instructions:\n";
+    stream << std::setw(10) << "instr" << std::setw(10) << "count" << std::setw(8) << "%\n";
+    for (size_t slot : slots)
+    {
+        uint32_t const instruction = slot < NumOperations
+                                         ? static_cast<uint32_t>(slot) << 26
+                                         : static_cast<uint32_t>(slot - NumOperations);
+        char const*    mnemonic    = GetMnemonic(instruction);
+
+        stream << std::setw(10) << (mnemonic ? mnemonic : "unknown") << std::setw(10)
+               << _counts[slot] << std::setw(8) << Percentage(_counts[slot], _instructions)
+               << '\n';
+    }
+
+    stream << "\nClasses:\n";
+    stream << std::setw(10) << "class" << std::setw(10) << "count" << std::setw(8) << "%\n";
+    for (size_t i = 0; i < NumInstructionClasses; ++i)
+    {
+        if (!_classCounts[i])
+            continue;
+        stream << std::setw(10) << GetClassName(static_cast<InstructionClass>(i))
+               << std::setw(10) << _classCounts[i] << std::setw(8)
+               << Percentage(_classCounts[i], _instructions) << '\n';
+    }
+
+    stream << "\nBranches:\n";
+    stream << std::setw(10) << "instr" << std::setw(10) << "taken" << std::setw(10) << "not taken"
+           << std::setw(8) << "taken%\n";
+
+    uint64_t totalBranches = 0, totalTaken = 0;
+    auto const writeBranches = [&](char const* name, uint64_t branches, uint64_t taken) {
+        stream << std::setw(10) << name << std::setw(10) << taken << std::setw(10)
+               << branches - taken << std::setw(8) << Percentage(taken, branches) << '\n';
+    };
+    for (BIFormatOp operation : { BIFormatOp::BEQ, BIFormatOp::BNE })
+    {
+        size_t const slot = static_cast<size_t>(operation);
+        writeBranches(GetMnemonic(static_cast<uint32_t>(slot) << 26), _counts[slot],
+                      _takenBranches[slot]);
+        totalBranches += _counts[slot];
+        totalTaken += _takenBranches[slot];
+    }
+    writeBranches("total", totalBranches, totalTaken);
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/InstructionMix.hh>
+#include <pip-mips-emu/Intervals.hh>
+
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+void Queue(AsyncWriter& writer, char const* data, size_t size)
+{
+    if (!writer.Write(data, size))
+        throw std::runtime_error { "Interval statistics are dropped" };
+}
+
+constexpr size_t Column(IntervalColumn column) noexcept
+{
+    return static_cast<size_t>(column);
+}
+
+}
+
+char const* GetColumnName(IntervalColumn column) noexcept
+{
+    switch (column)
+    {
+    case IntervalColumn::Cycle: return "cycle";
+    case IntervalColumn::Cycles: return "cycles";
+    case IntervalColumn::Instructions: return "instructions";
+    case IntervalColumn::LoadUseStalls: return "loadUseStalls";
+    case IntervalColumn::MemoryStalls: return "memoryStalls";
+    case IntervalColumn::FlushCycles: return "flushCycles";
+    case IntervalColumn::Branches: return "branches";
+    case IntervalColumn::TakenBranches: return "takenBranches";
+    case IntervalColumn::Mispredictions: return "mispredictions";
+    case IntervalColumn::Loads: return "loads";
+    case IntervalColumn::Stores: return "stores";
+    }
+    return "";
+}
+
+IntervalWriter::IntervalWriter(Emulator const& emulator,
+                               uint32_t        interval,
+                               AsyncWriter*    binary,
+                               AsyncWriter*    csv) :
+    _handler { *emulator.GetHandler() },
+    _collector { emulator },
+    _wbInstr { 0 },
+    _interval { interval },
+    _binary { binary },
+    _csv { csv },
+    _row {}
+{
+    if (interval == 0)
+        throw std::invalid_argument { "The interval must be positive" };
+
+    _wbInstr = emulator.FindRegister("WB_Instr");
+
+    for (auto& column : _columns) column.reserve(BlockRows);
+
+    if (_binary)
+    {
+        char header[IntervalFileHeaderSize];
+        std::memcpy(header, IntervalFileMagic, sizeof(IntervalFileMagic));
+        PutLittleEndianWord(header + 4, IntervalFileVersion);
+        PutLittleEndianWord(header + 8, interval);
+        PutLittleEndianWord(header + 12, static_cast<uint32_t>(NumIntervalColumns));
+        Queue(*_binary, header, sizeof(header));
+    }
+
+    if (_csv)
+    {
+        std::string line;
+        for (size_t i = 0; i < NumIntervalColumns; ++i)
+        {
+            line += i ? "," : "";
+            line += GetColumnName(static_cast<IntervalColumn>(i));
+        }
+        line += '\n';
+        Queue(*_csv, line.data(), line.size());
+    }
+}
+
+void IntervalWriter::OnCycleEnd(Memory const& memory)
+{
+    _collector.OnCycleEnd(memory);
+
+    if (_handler.CalcNumInstructions(memory))
+    {
+        uint32_t const instruction = memory.GetRegister(_wbInstr);
+        switch (Classify(instruction))
+        {
+        case InstructionClass::Branch:
+            ++_row[Column(IntervalColumn::Branches)];
+            if (InstructionMix::IsBranchTaken(instruction, memory))
+                ++_row[Column(IntervalColumn::TakenBranches)];
+            break;
+        case InstructionClass::Load: ++_row[Column(IntervalColumn::Loads)]; break;
+        case InstructionClass::Store: ++_row[Column(IntervalColumn::Stores)]; break;
+        default: break;
+        }
+    }
+
+    if (_collector.GetCounters().cycles - _last.cycles == _interval)
+        EndInterval();
+}
+
+void IntervalWriter::Flush()
+{
+    if (_collector.GetCounters().cycles != _last.cycles)
+        EndInterval();
+
+    size_t const numRows = _columns[0].size();
+    if (numRows == 0)
+        return;
+
+    if (_binary)
+    {
+        std::vector<char> block((1 + NumIntervalColumns * numRows) * 4);
+        char*             ptr = block.data();
+
+        PutLittleEndianWord(ptr, static_cast<uint32_t>(numRows));
+        ptr += 4;
+        for (auto const& column : _columns)
+        {
+            for (uint32_t value : column)
+            {
+                PutLittleEndianWord(ptr, value);
+                ptr += 4;
+            }
+        }
+        Queue(*_binary, block.data(), block.size());
+    }
+
+    if (_csv)
+    {
+        Queue(*_csv, _csvBuffer.data(), _csvBuffer.size());
+        _csvBuffer.clear();
+    }
+
+    for (auto& column : _columns) column.clear();
+}
+
+void IntervalWriter::EndInterval()
+{
+    PipelineCounters const& counters = _collector.GetCounters();
+
+    auto const delta = [&](uint64_t current, uint64_t last) {
+        return static_cast<uint32_t>(current - last);
+    };
+
+    _row[Column(IntervalColumn::Cycle)]        = static_cast<uint32_t>(counters.cycles);
+    _row[Column(IntervalColumn::Cycles)]       = delta(counters.cycles, _last.cycles);
+    _row[Column(IntervalColumn::Instructions)] = delta(counters.instructions, _last.instructions);
+    _row[Column(IntervalColumn::MemoryStalls)] = delta(counters.memoryStalls, _last.memoryStalls);
+    _row[Column(IntervalColumn::LoadUseStalls)]
+        = delta(counters.loadUseStalls, _last.loadUseStalls);
+    _row[Column(IntervalColumn::FlushCycles)]
+        = delta(counters.GetFlushCycles(), _last.GetFlushCycles());
+    _row[Column(IntervalColumn::Mispredictions)]
+        = delta(counters.mispredictionFlushes, _last.mispredictionFlushes);
+
+    for (size_t i = 0; i < NumIntervalColumns; ++i)
+    {
+        _columns[i].push_back(_row[i]);
+
+        if (_csv)
+        {
+            char buffer[16];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), _row[i]);
+            if (i)
+                _csvBuffer.push_back(',');
+            _csvBuffer.insert(_csvBuffer.end(), buffer, result.ptr);
+        }
+    }
+    if (_csv)
+        _csvBuffer.push_back('\n');
+
+    _last = counters;
+    _row.fill(0);
+
+    if (_columns[0].size() == BlockRows)
+        Flush();
+}
+
+std::vector<IntervalRow> DecodeIntervals(std::istream& is, uint32_t* interval)
+{
+    char header[IntervalFileHeaderSize];
+    if (!is.read(header, sizeof(header))
+        || std::memcmp(header, IntervalFileMagic, sizeof(IntervalFileMagic)) != 0)
+        throw std::runtime_error { "Not interval statistics" };
+    if (GetLittleEndianWord(header + 4) != IntervalFileVersion)
+        throw std::runtime_error { "Unsupported version of interval statistics" };
+    if (GetLittleEndianWord(header + 12) != NumIntervalColumns)
+        throw std::runtime_error { "Invalid number of columns" };
+    if (interval)
+        *interval = GetLittleEndianWord(header + 8);
+
+    std::vector<IntervalRow> rows;
+    std::vector<char>        block;
+
+    char count[4];
+    while (is.read(count, sizeof(count)))
+    {
+        size_t const numRows = GetLittleEndianWord(count);
+        if (numRows == 0 || numRows > IntervalWriter::BlockRows)
+            throw std::runtime_error { "Invalid number of rows" };
+
+        block.resize(NumIntervalColumns * numRows * 4);
+        if (!is.read(block.data(), static_cast<std::streamsize>(block.size())))
+            throw std::runtime_error { "Truncated block" };
+
+        size_t const first = rows.size();
+        rows.resize(first + numRows);
+        for (size_t column = 0; column < NumIntervalColumns; ++column)
+        {
+            char const* words = &block[column * numRows * 4];
+            for (size_t row = 0; row < numRows; ++row)
+                rows[first + row][column] = GetLittleEndianWord(words + row * 4);
+        }
+    }
+
+    if (is.gcount() != 0)
+        throw std::runtime_error { "Truncated block" };
+    return rows;
+}
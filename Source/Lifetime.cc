@@ -0,0 +1,148 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Lifetime.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+
+constexpr size_t IF_ID = 0, WB = Handler::NumStages - 1;
+
+}
+
+LifetimeTracker::LifetimeTracker(Emulator const& emulator) :
+    _handler { *emulator.GetHandler() }, _tracker { emulator }, _table {}, _stats {}, _cycles { 0 }
+{
+    // Marks the entries as free
+    for (InFlight& entry : _table)
+        entry.sequence = UINT64_MAX;
+}
+
+LifetimeStats LifetimeTracker::GetTotalStats() const noexcept
+{
+    LifetimeStats total;
+    for (LifetimeStats const& stats : _stats)
+    {
+        total.count += stats.count;
+        total.latencySum += stats.latencySum;
+        total.maxLatency = std::max(total.maxLatency, stats.maxLatency);
+        for (size_t i = 0; i < LifetimeStats::NumLatches; ++i)
+            total.latchCycles[i] += stats.latchCycles[i];
+        for (size_t i = 0; i < LifetimeStats::NumBuckets; ++i)
+            total.histogram[i] += stats.histogram[i];
+    }
+    return total;
+}
+
+void LifetimeTracker::OnCycleEnd(Memory const& memory) noexcept
+{
+    _tracker.Advance();
+    ++_cycles;
+
+    auto const& slots = _tracker.GetSlots();
+    for (size_t stage = 0; stage < slots.size(); ++stage)
+    {
+        PipelineSlot const& slot = slots[stage];
+        if (slot.cause != SlotCause::Instruction)
+            continue;
+
+        InFlight& entry = _table[slot.sequence % TableSize];
+        if (stage == IF_ID && entry.sequence != slot.sequence)
+        {
+            uint32_t const instruction = memory.GetWord(Address::MakeText(slot.pc - TextBase));
+
+            entry.sequence         = slot.sequence;
+            entry.instructionClass = Classify(instruction);
+            entry.cycles.fill(0);
+        }
+
+        if (entry.sequence == slot.sequence && entry.cycles[stage] == 0)
+            entry.cycles[stage] = _cycles;
+    }
+
+    // A committed instruction always reaches WB in this cycle
+    if (!_handler.CalcNumInstructions(memory))
+        return;
+
+    InFlight const& entry = _table[slots[WB].sequence % TableSize];
+    if (slots[WB].cause != SlotCause::Instruction || entry.sequence != slots[WB].sequence)
+        return;
+
+    LifetimeStats& stats   = _stats[static_cast<size_t>(entry.instructionClass)];
+    uint64_t const latency = entry.cycles[WB] - entry.cycles[IF_ID] + 1;
+
+    ++stats.count;
+    stats.latencySum += latency;
+    stats.maxLatency = std::max(stats.maxLatency, latency);
+    for (size_t i = 0; i < LifetimeStats::NumLatches; ++i)
+        stats.latchCycles[i] += entry.cycles[i + 1] - entry.cycles[i];
+    ++stats.histogram[std::min<uint64_t>(latency, LifetimeStats::NumBuckets - 1)];
+}
+
+void LifetimeTracker::WriteReport(std::ostream& stream) const
+{
+    static char const* const latchNames[] = { "IF/ID", "ID/EX", "EX/MEM", "MEM/WB" };
+
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    LifetimeStats const total = GetTotalStats();
+
+    auto const writeRow = [&](char const* name, LifetimeStats const& stats) {
+        stream << std::setw(10) << name << std::setw(10) << stats.count << std::setw(10)
+               << stats.GetAverageLatency() << std::setw(10) << stats.maxLatency;
+        for (uint64_t cycles : stats.latchCycles)
+        {
+            stream << std::setw(10)
+                   << (stats.count ? static_cast<double>(cycles) / stats.count : 0.0);
+        }
+        stream << '\n';
+    };
+
+    stream << "Lifetime of " << total.count << " committed instructions:\n";
+    stream << std::setw(10) << "class" << std::setw(10) << "count" << std::setw(10) << "latency"
+           << std::setw(10) << "max";
+    for (char const* name : latchNames)
+        stream << std::setw(10) << name;
+    stream << '\n';
+    for (size_t i = 0; i < NumInstructionClasses; ++i)
+    {
+        if (_stats[i].count)
+            writeRow(GetClassName(static_cast<InstructionClass>(i)), _stats[i]);
+    }
+    writeRow("total", total);
+
+    stream << "\nFetch-to-commit latency histogram:\n";
+    stream << std::setw(10) << "cycles" << std::setw(10) << "total";
+    for (size_t i = 0; i < NumInstructionClasses; ++i)
+    {
+        if (_stats[i].count)
+            stream << std::setw(10) << GetClassName(static_cast<InstructionClass>(i));
+    }
+    stream << '\n';
+    for (size_t bucket = 0; bucket < LifetimeStats::NumBuckets; ++bucket)
+    {
+        if (!total.histogram[bucket])
+            continue;
+
+        if (bucket == LifetimeStats::NumBuckets - 1)
+            stream << std::setw(9) << bucket << '+';
+        else
+            stream << std::setw(10) << bucket;
+        stream << std::setw(10) << total.histogram[bucket];
+        for (LifetimeStats const& stats : _stats)
+        {
+            if (stats.count)
+                stream << std::setw(10) << stats.histogram[bucket];
+        }
+        stream << '\n';
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
@@ -1,17 +1,36 @@
 // Copyright (c) 2021 Chanjung Kim (paxbun). All rights reserved.
 // Licensed under the MIT License.
 
+#include <pip-mips-emu/AccessTrace.hh>
+#include <pip-mips-emu/Allocations.hh>
+#include <pip-mips-emu/AsyncWriter.hh>
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Counters.hh>
+#include <pip-mips-emu/Coverage.hh>
+#include <pip-mips-emu/Dram.hh>
 #include <pip-mips-emu/Emulator.hh>
 #include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/HostProfiler.hh>
 #include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/InstructionMix.hh>
+#include <pip-mips-emu/Intervals.hh>
+#include <pip-mips-emu/Lifetime.hh>
 #include <pip-mips-emu/Memory.hh>
+#include <pip-mips-emu/PerfCounters.hh>
+#include <pip-mips-emu/Profiler.hh>
+#include <pip-mips-emu/ProgramCache.hh>
+#include <pip-mips-emu/Trace.hh>
+#include <pip-mips-emu/Vcd.hh>
+#include <pip-mips-emu/WriteBuffer.hh>
 
 #include <charconv>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <stdexcept>
+#include <string_view>
 
 enum class BranchPredictionType
 {
@@ -21,18 +40,137 @@ enum class BranchPredictionType
 
 struct Options
 {
-    BranchPredictionType  predictionType     = BranchPredictionType::AlwaysTaken;
-    std::optional<Range>  range              = std::nullopt;
-    bool                  dumpEachTickTock   = false;
-    bool                  dumpPcEachTickTock = false;
-    uint32_t              numInstructions    = std::numeric_limits<uint32_t>::max();
-    std::filesystem::path filePath {};
+    BranchPredictionType                 predictionType     = BranchPredictionType::AlwaysTaken;
+    std::optional<Range>                 range              = std::nullopt;
+    bool                                 dumpEachTickTock   = false;
+    bool                                 dumpPcEachTickTock = false;
+    bool                                 quiet              = false;
+    std::optional<std::filesystem::path> tracePath          = std::nullopt;
+    bool                                 dropTraceRecords   = false;
+    std::optional<std::filesystem::path> accessTracePath    = std::nullopt;
+    std::optional<std::filesystem::path> vcdPath            = std::nullopt;
+    VcdConfig                            vcd {};
+    std::optional<std::filesystem::path> countersPath       = std::nullopt;
+    std::optional<std::filesystem::path> profilePath        = std::nullopt;
+    std::optional<std::filesystem::path> lifetimePath       = std::nullopt;
+    std::optional<std::filesystem::path> mixPath            = std::nullopt;
+    std::optional<std::filesystem::path> coveragePath       = std::nullopt;
+    std::optional<std::filesystem::path> hostProfilePath    = std::nullopt;
+    bool                                 perf               = false;
+    std::optional<std::filesystem::path> allocationsPath    = std::nullopt;
+    std::optional<std::filesystem::path> intervalsPath      = std::nullopt;
+    std::optional<std::filesystem::path> intervalsCsvPath   = std::nullopt;
+    std::optional<uint32_t>              interval           = std::nullopt;
+    uint32_t                             numInstructions    = std::numeric_limits<uint32_t>::max();
+    std::optional<CacheConfig>           instructionCache   = std::nullopt;
+    std::optional<CacheConfig>           dataCache          = std::nullopt;
+    std::optional<DramConfig>            dram               = std::nullopt;
+    std::optional<WriteBufferConfig>     writeBuffer        = std::nullopt;
+    bool                                 useProgramCache    = false;
+    ProgramCacheConfig                   programCache {};
+    std::filesystem::path                filePath {};
 };
 
+uint32_t ParseNumber(std::string_view input, char const* message)
+{
+    uint32_t rtn;
+    auto     result = std::from_chars(input.data(), input.data() + input.size(), rtn);
+    if (result.ec != std::errc {} || result.ptr != input.data() + input.size())
+        throw std::runtime_error { message };
+    return rtn;
+}
+
+// Calls the given function for each pair in a comma-separated list of key=value pairs such as
+// "size=4096,assoc=2,repl=lru".
+template <typename Function>
+void ForEachKeyValue(char const* input, char const* message, Function&& function)
+{
+    std::string_view rest { input };
+    while (!rest.empty())
+    {
+        auto const       commaPos = rest.find(',');
+        std::string_view pair     = rest.substr(0, commaPos);
+        rest = commaPos == std::string_view::npos ? std::string_view {} : rest.substr(commaPos + 1);
+
+        auto const equalPos = pair.find('=');
+        if (equalPos == std::string_view::npos || !function(pair.substr(0, equalPos),
+                                                              pair.substr(equalPos + 1)))
+            throw std::runtime_error { message };
+    }
+}
+
+CacheConfig ParseCacheConfig(char const* input)
+{
+    CacheConfig config;
+    ForEachKeyValue(input, "Invalid cache configuration", [&](auto key, auto value) {
+        if (key == "size")
+            config.size = ParseNumber(value, "Invalid cache size");
+        else if (key == "assoc")
+            config.associativity = ParseNumber(value, "Invalid cache associativity");
+        else if (key == "line")
+            config.lineSize = ParseNumber(value, "Invalid cache line size");
+        else if (key == "penalty")
+            config.missPenalty = ParseNumber(value, "Invalid cache miss penalty");
+        else if (key == "repl" && value == "lru")
+            config.replacement = ReplacementPolicy::LRU;
+        else if (key == "repl" && value == "random")
+            config.replacement = ReplacementPolicy::Random;
+        else if (key == "write" && value == "wb")
+            config.writePolicy = WritePolicy::WriteBack;
+        else if (key == "write" && value == "wt")
+            config.writePolicy = WritePolicy::WriteThrough;
+        else
+            return false;
+        return true;
+    });
+    return config;
+}
+
+WriteBufferConfig ParseWriteBufferConfig(char const* input)
+{
+    WriteBufferConfig config;
+    ForEachKeyValue(input, "Invalid write buffer configuration", [&](auto key, auto value) {
+        if (key == "entries")
+            config.numEntries = ParseNumber(value, "Invalid number of write buffer entries");
+        else if (key == "drain")
+            config.drainCycles = ParseNumber(value, "Invalid write buffer drain cycles");
+        else
+            return false;
+        return true;
+    });
+    return config;
+}
+
+DramConfig ParseDramConfig(char const* input)
+{
+    DramConfig config;
+    ForEachKeyValue(input, "Invalid DRAM configuration", [&](auto key, auto value) {
+        if (key == "banks")
+            config.numBanks = ParseNumber(value, "Invalid number of DRAM banks");
+        else if (key == "row")
+            config.rowSize = ParseNumber(value, "Invalid DRAM row size");
+        else if (key == "trcd")
+            config.tRCD = ParseNumber(value, "Invalid DRAM tRCD");
+        else if (key == "tcas")
+            config.tCAS = ParseNumber(value, "Invalid DRAM tCAS");
+        else if (key == "trp")
+            config.tRP = ParseNumber(value, "Invalid DRAM tRP");
+        else if (key == "page" && value == "open")
+            config.pagePolicy = PagePolicy::Open;
+        else if (key == "page" && value == "closed")
+            config.pagePolicy = PagePolicy::Closed;
+        else
+            return false;
+        return true;
+    });
+    return config;
+}
+
 Options ParseCommandArgs(int argc, char* argv[])
 {
     bool branchPredictionTypeGiven = false;
     bool filePathGiven             = false;
+    bool cacheLimitGiven           = false;
 
     Options options;
     for (int i = 1; i < argc; ++i)
@@ -85,6 +223,148 @@ Options ParseCommandArgs(int argc, char* argv[])
                 throw std::runtime_error { "Duplicate option: '-p'" };
             options.dumpPcEachTickTock = true;
         }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            if (options.quiet)
+                throw std::runtime_error { "Duplicate option: '-q'" };
+            options.quiet = true;
+        }
+        else if (strcmp(argv[i], "-trace") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-trace'" };
+            if (options.tracePath)
+                throw std::runtime_error { "Duplicate option: '-trace'" };
+            options.tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-trace-drop") == 0)
+        {
+            if (options.dropTraceRecords)
+                throw std::runtime_error { "Duplicate option: '-trace-drop'" };
+            options.dropTraceRecords = true;
+        }
+        else if (strcmp(argv[i], "-access-trace") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-access-trace'" };
+            if (options.accessTracePath)
+                throw std::runtime_error { "Duplicate option: '-access-trace'" };
+            options.accessTracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-vcd") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-vcd'" };
+            if (options.vcdPath)
+                throw std::runtime_error { "Duplicate option: '-vcd'" };
+            options.vcdPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-vcd-filter") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing patterns after '-vcd-filter'" };
+            if (!options.vcd.patterns.empty())
+                throw std::runtime_error { "Duplicate option: '-vcd-filter'" };
+
+            std::string_view rest { argv[++i] };
+            while (!rest.empty())
+            {
+                auto const commaPos = rest.find(',');
+                options.vcd.patterns.emplace_back(rest.substr(0, commaPos));
+                rest = commaPos == std::string_view::npos ? std::string_view {}
+                                                          : rest.substr(commaPos + 1);
+            }
+        }
+        else if (strcmp(argv[i], "-counters") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-counters'" };
+            if (options.countersPath)
+                throw std::runtime_error { "Duplicate option: '-counters'" };
+            options.countersPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-profile") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-profile'" };
+            if (options.profilePath)
+                throw std::runtime_error { "Duplicate option: '-profile'" };
+            options.profilePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-lifetime") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-lifetime'" };
+            if (options.lifetimePath)
+                throw std::runtime_error { "Duplicate option: '-lifetime'" };
+            options.lifetimePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-mix") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-mix'" };
+            if (options.mixPath)
+                throw std::runtime_error { "Duplicate option: '-mix'" };
+            options.mixPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-coverage") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-coverage'" };
+            if (options.coveragePath)
+                throw std::runtime_error { "Duplicate option: '-coverage'" };
+            options.coveragePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-host-profile") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-host-profile'" };
+            if (options.hostProfilePath)
+                throw std::runtime_error { "Duplicate option: '-host-profile'" };
+            options.hostProfilePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-perf") == 0)
+        {
+            if (options.perf)
+                throw std::runtime_error { "Duplicate option: '-perf'" };
+            options.perf = true;
+        }
+        else if (strcmp(argv[i], "-allocations") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-allocations'" };
+            if (options.allocationsPath)
+                throw std::runtime_error { "Duplicate option: '-allocations'" };
+            if (!AllocationCountingEnabled)
+                throw std::runtime_error { "Allocation counting is not enabled in this build" };
+            options.allocationsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-intervals") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-intervals'" };
+            if (options.intervalsPath)
+                throw std::runtime_error { "Duplicate option: '-intervals'" };
+            options.intervalsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-intervals-csv") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing file after '-intervals-csv'" };
+            if (options.intervalsCsvPath)
+                throw std::runtime_error { "Duplicate option: '-intervals-csv'" };
+            options.intervalsCsvPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-interval") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing number of cycles after '-interval'" };
+            if (options.interval)
+                throw std::runtime_error { "Duplicate option: '-interval'" };
+            options.interval = ParseNumber(argv[++i], "Invalid number of cycles");
+            if (*options.interval == 0)
+                throw std::runtime_error { "Invalid number of cycles" };
+        }
         else if (strcmp(argv[i], "-n") == 0)
         {
             if (i == argc - 1)
@@ -96,6 +376,63 @@ Options ParseCommandArgs(int argc, char* argv[])
             if (result.ec != std::errc {})
                 throw std::runtime_error { "Invalid number of instructions" };
         }
+        else if (strcmp(argv[i], "-icache") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing cache configuration after '-icache'" };
+            if (options.instructionCache)
+                throw std::runtime_error { "Duplicate option: '-icache'" };
+            options.instructionCache = ParseCacheConfig(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-dcache") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing cache configuration after '-dcache'" };
+            if (options.dataCache)
+                throw std::runtime_error { "Duplicate option: '-dcache'" };
+            options.dataCache = ParseCacheConfig(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-dram") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing DRAM configuration after '-dram'" };
+            if (options.dram)
+                throw std::runtime_error { "Duplicate option: '-dram'" };
+            options.dram = ParseDramConfig(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-wbuf") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing write buffer configuration after '-wbuf'" };
+            if (options.writeBuffer)
+                throw std::runtime_error { "Duplicate option: '-wbuf'" };
+            options.writeBuffer = ParseWriteBufferConfig(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-cache") == 0)
+        {
+            if (options.useProgramCache)
+                throw std::runtime_error { "Duplicate option: '-cache'" };
+            options.useProgramCache = true;
+        }
+        else if (strcmp(argv[i], "-cache-dir") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing directory after '-cache-dir'" };
+            if (!options.programCache.directory.empty())
+                throw std::runtime_error { "Duplicate option: '-cache-dir'" };
+            options.programCache.directory = argv[++i];
+        }
+        else if (strcmp(argv[i], "-cache-limit") == 0)
+        {
+            if (i == argc - 1)
+                throw std::runtime_error { "Missing size in MiB after '-cache-limit'" };
+            if (cacheLimitGiven)
+                throw std::runtime_error { "Duplicate option: '-cache-limit'" };
+            uint32_t const limit = ParseNumber(argv[++i], "Invalid cache limit");
+
+            cacheLimitGiven              = true;
+            options.programCache.maxSize = uint64_t { limit } << 20;
+        }
         else
         {
             if (filePathGiven)
@@ -111,45 +448,83 @@ Options ParseCommandArgs(int argc, char* argv[])
     if (!filePathGiven)
         throw std::runtime_error { "No file is given" };
 
+    if (options.quiet && (options.dumpEachTickTock || options.dumpPcEachTickTock))
+        throw std::runtime_error { "'-q' cannot be used with '-d' or '-p'" };
+
+    if (options.dropTraceRecords && !options.tracePath)
+        throw std::runtime_error { "'-trace-drop' cannot be used without '-trace'" };
+
+    if (!options.vcd.patterns.empty() && !options.vcdPath)
+        throw std::runtime_error { "'-vcd-filter' cannot be used without '-vcd'" };
+
+    if (!options.useProgramCache && (!options.programCache.directory.empty() || cacheLimitGiven))
+    {
+        throw std::runtime_error { "'-cache-dir' and '-cache-limit' cannot be used without "
+                                   "'-cache'" };
+    }
+
+    // Without '-cache-dir', the decoded programs are cached under the cache directory of the user
+    if (options.useProgramCache && options.programCache.directory.empty())
+        options.programCache.directory = ProgramCache::GetDefaultDirectory();
+
     return options;
 }
 
-std::pair<std::vector<uint8_t>, std::vector<uint8_t>> LoadMemory(Options const& options)
+FileReadResult ReadProgram(Options const& options)
 {
-    FileReadResult fileResult { ReadFile(options.filePath) };
+    if (options.useProgramCache && !options.programCache.directory.empty())
+        return ProgramCache { options.programCache }.Read(options.filePath);
+    else
+        return ReadFile(options.filePath);
+}
+
+CanRead LoadMemory(Options const& options)
+{
+    FileReadResult fileResult { ReadProgram(options) };
     if (std::holds_alternative<CannotRead>(fileResult))
-    {
-        CannotRead  error = std::get<CannotRead>(fileResult);
-        char const* msg   = "Unknown file I/O error";
-        switch (error.error.type)
-        {
-        case FileReadError::Type::FileDoesNotExist:
-        {
-            msg = "File does not exist";
-            break;
-        }
-        case FileReadError::Type::GivenPathIsDirectory:
-        {
-            msg = "File is directory";
-            break;
-        }
-        case FileReadError::Type::InvalidFormat:
-        {
-            msg = "Invalid file";
-            break;
-        }
-        case FileReadError::Type::SectionSizeDoesNotMatch:
-        {
-            msg = "Section size does not match";
-            break;
-        }
-        }
+        throw std::runtime_error { std::get<CannotRead>(fileResult).error.GetMessage() };
 
-        throw std::runtime_error { msg };
-    }
-    CanRead file = std::get<CanRead>(fileResult);
+    return std::get<CanRead>(std::move(fileResult));
+}
+
+void DumpCacheStats(char const* name, Cache const& cache, std::ostream& stream)
+{
+    CacheStats const& stats = cache.GetStats();
+
+    stream << name << " statistics:\n";
+    stream << "------------------------------------\n";
+    stream << "Accesses: " << stats.GetAccesses() << '\n';
+    stream << "Hits: " << stats.GetHits() << '\n';
+    stream << "Misses: " << stats.GetMisses() << " (read " << stats.readMisses << ", write "
+           << stats.writeMisses << ")\n";
+    stream << "Write-backs: " << stats.writeBacks << '\n';
+}
+
+void DumpWriteBufferStats(WriteBuffer const& writeBuffer, std::ostream& stream)
+{
+    WriteBufferStats const& stats = writeBuffer.GetStats();
+
+    stream << "Write buffer statistics:\n";
+    stream << "------------------------------------\n";
+    stream << "Stores: " << stats.stores << '\n';
+    stream << "Loads: " << stats.loads << " (forwarded " << stats.forwardedLoads << ")\n";
+    stream << "Full-buffer stalls: " << stats.fullStalls << " (" << stats.fullStallCycles
+           << " cycles)\n";
+    stream << "Max occupancy: " << stats.maxOccupancy << '\n';
+}
 
-    return std::make_pair(std::move(file.text), std::move(file.data));
+void DumpDramStats(Dram const& dram, std::ostream& stream)
+{
+    DramStats const& stats = dram.GetStats();
+
+    stream << "DRAM statistics:\n";
+    stream << "------------------------------------\n";
+    stream << "Accesses: " << stats.GetAccesses() << '\n';
+    stream << "Row hits: " << stats.rowHits << '\n';
+    stream << "Row misses: " << stats.rowMisses << '\n';
+    stream << "Row conflicts: " << stats.rowConflicts << '\n';
+    stream << "Row-hit rate: " << stats.GetRowHitRate() << '\n';
+    stream << "Average access latency: " << stats.GetAverageLatency() << '\n';
 }
 
 int main(int argc, char* argv[])
@@ -161,10 +536,32 @@ int main(int argc, char* argv[])
         Options         options = ParseCommandArgs(argc, argv);
         EmulatorBuilder builder;
 
-        builder.AddDatapath<InstructionFetch>()
+        std::shared_ptr<Dram> dram;
+        if (options.dram)
+            dram = std::make_shared<Dram>(options.dram.value());
+
+        std::shared_ptr<Cache> instructionCache, dataCache;
+        if (options.instructionCache)
+            instructionCache = std::make_shared<Cache>(options.instructionCache.value(), dram);
+        if (options.dataCache)
+            dataCache = std::make_shared<Cache>(options.dataCache.value(), dram);
+
+        // Without a data cache, loads and stores go to the DRAM directly
+        MemoryLevelPtr dataLevel = dataCache;
+        if (!dataLevel)
+            dataLevel = dram;
+
+        std::shared_ptr<WriteBuffer> writeBuffer;
+        if (options.writeBuffer)
+        {
+            writeBuffer = std::make_shared<WriteBuffer>(options.writeBuffer.value(), dataLevel);
+            dataLevel   = writeBuffer;
+        }
+
+        builder.AddDatapath<InstructionFetch>(instructionCache)
             .AddDatapath<InstructionDecode>()
             .AddDatapath<Execution>()
-            .AddDatapath<MemoryAccess>()
+            .AddDatapath<MemoryAccess>(dataLevel)
             .AddDatapath<WriteBack>()
             .AddHandler<DefaultHandler>();
 
@@ -173,19 +570,178 @@ int main(int argc, char* argv[])
         else if (options.predictionType == BranchPredictionType::AlwaysNotTaken)
             builder.AddController<ANTPPipelineStateController>();
 
-        auto [text, data]       = LoadMemory(options);
-        auto [emulator, memory] = builder.Build(std::move(text), std::move(data));
+        CanRead file            = LoadMemory(options);
+        auto [emulator, memory] = builder.Build(std::move(file.text), std::move(file.data));
         auto& handler           = emulator.GetHandler();
+        memory.SetRegister(Memory::PC, file.entryPoint);
+
+        // With a trace, the state of each cycle is written to the trace instead of the standard
+        // output. The trace file is written on another thread so that the emulation does not wait
+        // for the I/O.
+        std::unique_ptr<AsyncWriter> traceFile;
+        std::unique_ptr<TraceWriter> traceWriter;
+        if (options.tracePath)
+        {
+            AsyncWriterConfig fileConfig;
+            if (options.dropTraceRecords)
+                fileConfig.policy = OverflowPolicy::Drop;
+            try
+            {
+                traceFile = std::make_unique<AsyncWriter>(options.tracePath.value(), fileConfig);
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot open the trace file" };
+            }
+
+            TraceConfig config;
+            config.dumpPCs       = options.dumpPcEachTickTock;
+            config.dumpRegisters = options.dumpEachTickTock;
+            config.range         = options.range;
+            traceWriter          = std::make_unique<TraceWriter>(*traceFile, config);
+        }
+
+        // The memory access trace is also written on another thread
+        std::unique_ptr<AsyncWriter>       accessTraceFile;
+        std::unique_ptr<AccessTraceWriter> accessTrace;
+        if (options.accessTracePath)
+        {
+            try
+            {
+                accessTraceFile = std::make_unique<AsyncWriter>(options.accessTracePath.value(),
+                                                                AsyncWriterConfig {});
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot open the memory access trace file" };
+            }
+            accessTrace = std::make_unique<AccessTraceWriter>(*accessTraceFile);
+        }
+
+        // With a trace, only the locations written by each cycle are compared with the previous
+        // cycle
+        WriteRecorder writeRecorder;
+
+        std::ofstream              vcdFile;
+        std::unique_ptr<VcdWriter> vcdWriter;
+        if (options.vcdPath)
+        {
+            vcdFile.open(options.vcdPath.value(), std::ios::binary);
+            if (!vcdFile)
+                throw std::runtime_error { "Cannot open the VCD file" };
+            vcdWriter = std::make_unique<VcdWriter>(vcdFile, emulator, options.vcd);
+        }
+
+        std::unique_ptr<CounterCollector> counters;
+        if (options.countersPath)
+            counters = std::make_unique<CounterCollector>(emulator);
+
+        std::unique_ptr<Profiler> profiler;
+        if (options.profilePath)
+            profiler = std::make_unique<Profiler>(emulator, memory);
+
+        std::unique_ptr<LifetimeTracker> lifetime;
+        if (options.lifetimePath)
+            lifetime = std::make_unique<LifetimeTracker>(emulator);
+
+        std::unique_ptr<InstructionMix> mix;
+        if (options.mixPath)
+            mix = std::make_unique<InstructionMix>(emulator);
+
+        std::unique_ptr<CoverageCollector> coverage;
+        if (options.coveragePath)
+            coverage = std::make_unique<CoverageCollector>(memory);
+
+        std::unique_ptr<HostProfiler> hostProfiler;
+        if (options.hostProfilePath)
+            hostProfiler = std::make_unique<HostProfiler>(emulator);
+
+        std::unique_ptr<AllocationProfiler> allocations;
+        if (options.allocationsPath)
+            allocations = std::make_unique<AllocationProfiler>(emulator);
+
+        // Like the trace, interval statistics are written on other threads
+        std::unique_ptr<AsyncWriter>    intervalsFile, intervalsCsvFile;
+        std::unique_ptr<IntervalWriter> intervals;
+        if (options.intervalsPath || options.intervalsCsvPath)
+        {
+            try
+            {
+                if (options.intervalsPath)
+                {
+                    intervalsFile = std::make_unique<AsyncWriter>(options.intervalsPath.value(),
+                                                                  AsyncWriterConfig {});
+                }
+                if (options.intervalsCsvPath)
+                {
+                    intervalsCsvFile = std::make_unique<AsyncWriter>(
+                        options.intervalsCsvPath.value(), AsyncWriterConfig {});
+                }
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot open the interval statistics file" };
+            }
+            intervals = std::make_unique<IntervalWriter>(emulator,
+                                                         options.interval.value_or(10000),
+                                                         intervalsFile.get(),
+                                                         intervalsCsvFile.get());
+        }
+
+        // Observers which are not enabled are skipped at runtime. Without any of them, the
+        // emulator runs without the hooks. The host profilers are kept in a separate composite,
+        // so that the other observed runs do not read the host timer.
+        WriteRecorder* const                 recorder = traceWriter ? &writeRecorder : nullptr;
+        OptionalObserver<WriteRecorder>      recorderHook { recorder };
+        OptionalObserver<AccessTraceWriter>  accessTraceHook { accessTrace.get() };
+        OptionalObserver<VcdWriter>          vcdHook { vcdWriter.get() };
+        OptionalObserver<CounterCollector>   countersHook { counters.get() };
+        OptionalObserver<Profiler>           profilerHook { profiler.get() };
+        OptionalObserver<LifetimeTracker>    lifetimeHook { lifetime.get() };
+        OptionalObserver<InstructionMix>     mixHook { mix.get() };
+        OptionalObserver<CoverageCollector>  coverageHook { coverage.get() };
+        OptionalObserver<IntervalWriter>     intervalsHook { intervals.get() };
+        OptionalObserver<HostProfiler>       hostProfilerHook { hostProfiler.get() };
+        OptionalObserver<AllocationProfiler> allocationsHook { allocations.get() };
+        CompositeObserver                    observer { recorderHook, accessTraceHook, vcdHook,
+                                                        countersHook, profilerHook, lifetimeHook,
+                                                        mixHook, coverageHook, intervalsHook };
+        CompositeObserver hostObserver { observer, hostProfilerHook, allocationsHook };
+        static_assert(!ObservesHostTicks<decltype(observer)>::value);
+
+        bool const observed = traceWriter || accessTrace || vcdWriter || counters || profiler
+                              || lifetime || mix || coverage || intervals;
+        bool const hostObserved = hostProfiler || allocations;
+        bool const printEachTickTock = !options.quiet && !traceWriter;
+
+        // Host counters which cannot be opened are reported as not available
+        std::unique_ptr<PerfCounters> perfCounters;
+        if (options.perf)
+        {
+            perfCounters = std::make_unique<PerfCounters>();
+            perfCounters->Start();
+        }
 
         TickTockResult result = TickTockResult::Success;
 
         uint32_t i, j = 0;
         for (i = 1; j < options.numInstructions && !emulator.IsTerminated(memory); ++i)
         {
-            result = emulator.TickTock(memory, j);
+            if (hostObserved)
+                result = emulator.TickTock(memory, j, hostObserver);
+            else if (observed)
+                result = emulator.TickTock(memory, j, observer);
+            else
+                result = emulator.TickTock(memory, j);
             if (result != TickTockResult::Success)
                 break;
 
+            if (traceWriter)
+                traceWriter->WriteCycle(i, memory, *handler, writeRecorder.GetWrites());
+
+            if (!printEachTickTock)
+                continue;
+
             std::cout << "===== Cycle " << i << " =====\n";
 
             if (options.dumpPcEachTickTock)
@@ -207,6 +763,122 @@ int main(int argc, char* argv[])
             }
         }
 
+        if (perfCounters)
+        {
+            perfCounters->Stop();
+            WritePerfReport(*perfCounters, i - 1, j, std::cerr);
+        }
+
+        if (traceWriter)
+        {
+            traceWriter->Flush();
+            try
+            {
+                traceFile->Close();
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot write the trace file" };
+            }
+
+            if (uint64_t const droppedBytes = traceFile->GetStats().droppedBytes)
+                std::cerr << "Dropped " << droppedBytes / TraceRecordSize << " trace records\n";
+        }
+
+        if (accessTrace)
+        {
+            accessTrace->Flush();
+            try
+            {
+                accessTraceFile->Close();
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot write the memory access trace file" };
+            }
+        }
+
+        if (vcdWriter)
+        {
+            vcdWriter->Flush();
+            if (!vcdFile.flush())
+                throw std::runtime_error { "Cannot write the VCD file" };
+        }
+
+        if (counters)
+        {
+            std::ofstream countersFile { options.countersPath.value() };
+            WriteCountersJson(counters->GetCounters(), countersFile);
+            if (!countersFile.flush())
+                throw std::runtime_error { "Cannot write the counters file" };
+        }
+
+        if (profiler)
+        {
+            std::ofstream profileFile { options.profilePath.value() };
+            profiler->WriteFlatProfile(memory, profileFile);
+            profileFile << '\n';
+            profiler->WriteAnnotatedListing(memory, profileFile);
+            if (!profileFile.flush())
+                throw std::runtime_error { "Cannot write the profile file" };
+        }
+
+        if (lifetime)
+        {
+            std::ofstream lifetimeFile { options.lifetimePath.value() };
+            lifetime->WriteReport(lifetimeFile);
+            if (!lifetimeFile.flush())
+                throw std::runtime_error { "Cannot write the lifetime file" };
+        }
+
+        if (mix)
+        {
+            std::ofstream mixFile { options.mixPath.value() };
+            mix->WriteReport(mixFile);
+            if (!mixFile.flush())
+                throw std::runtime_error { "Cannot write the instruction mix file" };
+        }
+
+        if (coverage)
+        {
+            std::ofstream coverageFile { options.coveragePath.value(), std::ios::binary };
+            coverage->GetCoverage().Write(coverageFile);
+            if (!coverageFile.flush())
+                throw std::runtime_error { "Cannot write the coverage file" };
+        }
+
+        if (hostProfiler)
+        {
+            std::ofstream hostProfileFile { options.hostProfilePath.value() };
+            hostProfiler->WriteReport(hostProfileFile);
+            if (!hostProfileFile.flush())
+                throw std::runtime_error { "Cannot write the host profile file" };
+        }
+
+        if (allocations)
+        {
+            std::ofstream allocationsFile { options.allocationsPath.value() };
+            allocations->WriteReport(allocationsFile);
+            if (!allocationsFile.flush())
+                throw std::runtime_error { "Cannot write the allocations file" };
+        }
+
+        if (intervals)
+        {
+            intervals->Flush();
+            try
+            {
+                if (intervalsFile)
+                    intervalsFile->Close();
+                if (intervalsCsvFile)
+                    intervalsCsvFile->Close();
+            }
+            catch (std::runtime_error const&)
+            {
+                throw std::runtime_error { "Cannot write the interval statistics file" };
+            }
+        }
+
         std::cout << "===== Completion cycle: " << (i - 1) << " =====\n";
 
         handler->DumpPCs(memory, std::cout);
@@ -221,6 +893,30 @@ int main(int argc, char* argv[])
             std::cout << '\n';
         }
 
+        if (instructionCache)
+        {
+            DumpCacheStats("I-cache", *instructionCache, std::cout);
+            std::cout << '\n';
+        }
+
+        if (dataCache)
+        {
+            DumpCacheStats("D-cache", *dataCache, std::cout);
+            std::cout << '\n';
+        }
+
+        if (writeBuffer)
+        {
+            DumpWriteBufferStats(*writeBuffer, std::cout);
+            std::cout << '\n';
+        }
+
+        if (dram)
+        {
+            DumpDramStats(*dram, std::cout);
+            std::cout << '\n';
+        }
+
         return 0;
     }
     catch (std::exception const& ex)
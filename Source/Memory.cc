@@ -5,6 +5,131 @@
 #include <pip-mips-emu/Memory.hh>
 
 #include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define PIP_MIPS_EMU_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace
+{
+
+inline uint32_t CountTrailingZeros(uint32_t value) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long rtn;
+    _BitScanForward(&rtn, value);
+    return static_cast<uint32_t>(rtn);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+/// <summary>
+/// Returns the index of the first element in <c>[begin, size)</c> for which whether
+/// <c>lhs[i] == rhs[i]</c> equals to <c>equal</c>, or <c>size</c> if there is no such element.
+/// </summary>
+template <typename T>
+size_t FindFirst(T const* lhs, T const* rhs, size_t begin, size_t size, bool equal) noexcept
+{
+    size_t idx = begin;
+#if defined(PIP_MIPS_EMU_SSE2)
+    constexpr size_t NumLanes = 16 / sizeof(T);
+
+    auto compare = [](T const* lhs, T const* rhs) noexcept {
+        __m128i const l = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs));
+        __m128i const r = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs));
+        if constexpr (sizeof(T) == 1)
+            return _mm_cmpeq_epi8(l, r);
+        else
+            return _mm_cmpeq_epi32(l, r);
+    };
+
+    // Looking for the first mismatch is the common case, so four vectors are checked at once
+    if (!equal)
+    {
+        for (; idx + 4 * NumLanes <= size; idx += 4 * NumLanes)
+        {
+            __m128i const eq = _mm_and_si128(
+                _mm_and_si128(compare(lhs + idx, rhs + idx),
+                              compare(lhs + idx + NumLanes, rhs + idx + NumLanes)),
+                _mm_and_si128(compare(lhs + idx + 2 * NumLanes, rhs + idx + 2 * NumLanes),
+                              compare(lhs + idx + 3 * NumLanes, rhs + idx + 3 * NumLanes)));
+            if (_mm_movemask_epi8(eq) != 0xFFFF)
+                break;
+        }
+    }
+
+    uint32_t const flip = equal ? 0 : 0xFFFF;
+    for (; idx + NumLanes <= size; idx += NumLanes)
+    {
+        uint32_t const mask
+            = static_cast<uint32_t>(_mm_movemask_epi8(compare(lhs + idx, rhs + idx))) ^ flip;
+        if (mask)
+            return idx + CountTrailingZeros(mask) / sizeof(T);
+    }
+#else
+    // Compare eight bytes at once while looking for a mismatch
+    if (!equal)
+    {
+        constexpr size_t NumElems = sizeof(uint64_t) / sizeof(T);
+        for (; idx + NumElems <= size; idx += NumElems)
+        {
+            uint64_t l, r;
+            std::memcpy(&l, lhs + idx, sizeof(l));
+            std::memcpy(&r, rhs + idx, sizeof(r));
+            if (l != r)
+                break;
+        }
+    }
+#endif
+
+    for (; idx < size; ++idx)
+    {
+        if ((lhs[idx] == rhs[idx]) == equal)
+            return idx;
+    }
+    return size;
+}
+
+void DiffSegments(Address::BaseType          base,
+                  std::vector<uint8_t> const& lhs,
+                  std::vector<uint8_t> const& rhs,
+                  std::vector<Range>&         out)
+{
+    size_t const commonSize = std::min(lhs.size(), rhs.size());
+    size_t const maxSize    = std::max(lhs.size(), rhs.size());
+
+    size_t begin = FindFirst(lhs.data(), rhs.data(), 0, commonSize, false);
+    while (begin < commonSize)
+    {
+        size_t const end = FindFirst(lhs.data(), rhs.data(), begin, commonSize, true);
+        if (end == commonSize)
+        {
+            // Merged with the bytes which exist in only one of the segments
+            out.push_back(Range { Address { base, static_cast<uint32_t>(begin) },
+                                  Address { base, static_cast<uint32_t>(maxSize - 1) } });
+            return;
+        }
+
+        out.push_back(Range { Address { base, static_cast<uint32_t>(begin) },
+                              Address { base, static_cast<uint32_t>(end - 1) } });
+        begin = FindFirst(lhs.data(), rhs.data(), end, commonSize, false);
+    }
+
+    if (commonSize < maxSize)
+    {
+        out.push_back(Range { Address { base, static_cast<uint32_t>(commonSize) },
+                              Address { base, static_cast<uint32_t>(maxSize - 1) } });
+    }
+}
+
+}
 
 bool Address::Parse(char const* begin, char const* end, Address& out) noexcept
 {
@@ -131,4 +256,98 @@ void Memory::SetWord(Address address, uint32_t word)
     ptr[1] = static_cast<uint8_t>(word >> 16 & 0xFF);
     ptr[2] = static_cast<uint8_t>(word >> 8 & 0xFF);
     ptr[3] = static_cast<uint8_t>(word >> 0 & 0xFF);
-}
\ No newline at end of file
+}
+
+void Memory::ReadBytes(Address address, uint8_t* out, size_t size) const noexcept
+{
+    auto&        segment = GetSegmentByBase(address.base);
+    size_t const offset  = address.offset;
+
+    size_t numCopied = 0;
+    if (offset < segment.size())
+    {
+        numCopied = std::min(size, segment.size() - offset);
+        std::memcpy(out, segment.data() + offset, numCopied);
+    }
+    std::memset(out + numCopied, 0, size - numCopied);
+}
+
+void Memory::WriteBytes(Address address, uint8_t const* bytes, size_t size)
+{
+    auto&        segment = GetSegmentByBase(address.base);
+    size_t const offset  = address.offset;
+    if (offset > segment.size() || size > segment.size() - offset)
+        throw std::out_of_range { "address out of range" };
+
+    std::memcpy(segment.data() + offset, bytes, size);
+}
+
+void Memory::ReadWords(Address address, uint32_t* out, size_t count) const noexcept
+{
+    auto&        segment = GetSegmentByBase(address.base);
+    size_t const offset  = address.offset;
+
+    // Words entirely inside the segment
+    size_t numFullWords = 0;
+    if (offset < segment.size())
+        numFullWords = std::min(count, (segment.size() - offset) / 4);
+
+    uint8_t const* ptr = segment.data() + offset;
+    for (size_t i = 0; i < numFullWords; ++i, ptr += 4)
+    {
+        out[i] = static_cast<uint32_t>(ptr[0]) << 24 | static_cast<uint32_t>(ptr[1]) << 16
+                 | static_cast<uint32_t>(ptr[2]) << 8 | static_cast<uint32_t>(ptr[3]) << 0;
+    }
+
+    address.offset += static_cast<uint32_t>(numFullWords * 4);
+    for (size_t i = numFullWords; i < count; ++i, address.MoveToNext()) out[i] = GetWord(address);
+}
+
+MemoryView Memory::View(Address address, size_t size) const
+{
+    auto&        segment = GetSegmentByBase(address.base);
+    size_t const offset  = address.offset;
+    if (offset > segment.size() || size > segment.size() - offset)
+        throw std::out_of_range { "address out of range" };
+
+    return MemoryView { segment.data() + offset, size };
+}
+
+MemoryView Memory::View(Address::BaseType base) const
+{
+    auto& segment = GetSegmentByBase(base);
+    return MemoryView { segment.data(), segment.size() };
+}
+
+uint64_t Memory::Hash() const noexcept
+{
+    uint64_t hash = Hash64(_registers.data(), _registers.size() * sizeof(uint32_t));
+    hash          = Hash64(_text.data(), _text.size(), hash);
+    hash          = Hash64(_data.data(), _data.size(), hash);
+    return hash;
+}
+
+MemoryDiff Memory::Diff(Memory const& lhs, Memory const& rhs)
+{
+    MemoryDiff rtn;
+
+    size_t const commonNumRegisters = std::min(lhs._registers.size(), rhs._registers.size());
+    size_t const maxNumRegisters    = std::max(lhs._registers.size(), rhs._registers.size());
+
+    uint32_t const* lhsRegisters = lhs._registers.data();
+    uint32_t const* rhsRegisters = rhs._registers.data();
+
+    size_t idx = FindFirst(lhsRegisters, rhsRegisters, 0, commonNumRegisters, false);
+    while (idx < commonNumRegisters)
+    {
+        rtn.registers.push_back(static_cast<uint32_t>(idx));
+        idx = FindFirst(lhsRegisters, rhsRegisters, idx + 1, commonNumRegisters, false);
+    }
+    for (idx = commonNumRegisters; idx < maxNumRegisters; ++idx)
+        rtn.registers.push_back(static_cast<uint32_t>(idx));
+
+    DiffSegments(Address::BaseType::Text, lhs._text, rhs._text, rtn.ranges);
+    DiffSegments(Address::BaseType::Data, lhs._data, rhs._data, rtn.ranges);
+
+    return rtn;
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/PerfCounters.hh>
+
+#include <iomanip>
+#include <ostream>
+
+#if defined(__linux__)
+#    include <cstring>
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace
+{
+
+char const* const EventNames[] { "cycles", "instructions", "cache-misses", "branch-misses" };
+
+#if defined(__linux__)
+
+uint64_t const EventConfigs[] {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int OpenEvent(uint64_t config) noexcept
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif
+
+}
+
+PerfCounters::PerfCounters() noexcept
+{
+    _fds.fill(-1);
+#if defined(__linux__)
+    for (size_t i = 0; i < NumPerfEvents; ++i) _fds[i] = OpenEvent(EventConfigs[i]);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::IsAnyAvailable() const noexcept
+{
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+            return true;
+    }
+    return false;
+}
+
+void PerfCounters::Start() noexcept
+{
+#if defined(__linux__)
+    for (int fd : _fds)
+    {
+        if (fd < 0)
+            continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void PerfCounters::Stop() noexcept
+{
+#if defined(__linux__)
+    for (int fd : _fds)
+    {
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+}
+
+std::optional<uint64_t> PerfCounters::Read(PerfEvent event) const noexcept
+{
+#if defined(__linux__)
+    int const fd = _fds[static_cast<size_t>(event)];
+    if (fd < 0)
+        return std::nullopt;
+
+    // The value, the time the counter was enabled and the time it was running
+    uint64_t values[3];
+    if (read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || !values[2])
+        return std::nullopt;
+
+    if (values[2] == values[1])
+        return values[0];
+    return static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+#else
+    static_cast<void>(event);
+    return std::nullopt;
+#endif
+}
+
+void WritePerfReport(PerfCounters const& counters,
+                     uint64_t            emulatedCycles,
+                     uint64_t            emulatedInstructions,
+                     std::ostream&       stream)
+{
+    if (!counters.IsAnyAvailable())
+    {
+        stream << "Host counters are not available\n";
+        return;
+    }
+
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    stream << "Host counters of " << emulatedCycles << " emulated cycles and "
+           << emulatedInstructions << " emulated instructions:\n";
+    for (size_t i = 0; i < NumPerfEvents; ++i)
+    {
+        stream << std::setw(16) << EventNames[i] << "  ";
+        if (auto const value = counters.Read(static_cast<PerfEvent>(i)))
+            stream << value.value() << '\n';
+        else
+            stream << "not available\n";
+    }
+
+    auto const cycles       = counters.Read(PerfEvent::Cycles);
+    auto const instructions = counters.Read(PerfEvent::Instructions);
+    if (instructions && emulatedCycles)
+    {
+        stream << "Host instructions per emulated cycle: "
+               << static_cast<double>(instructions.value()) / emulatedCycles << '\n';
+    }
+    if (instructions && cycles && cycles.value())
+    {
+        stream << "Host IPC: " << static_cast<double>(instructions.value()) / cycles.value()
+               << '\n';
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Profiler.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+
+void WriteHeader(std::ostream& stream)
+{
+    stream << std::setw(10) << "cycles" << std::setw(8) << "%" << std::setw(10) << "commits"
+           << std::setw(10) << "stalls" << std::setw(10) << "flushes"
+           << "  address     instruction\n";
+}
+
+void WriteEntry(ProfileEntry const& entry,
+                uint64_t            totalCycles,
+                uint32_t            pc,
+                uint32_t            instruction,
+                std::ostream&       stream)
+{
+    double const percentage
+        = totalCycles ? 100.0 * static_cast<double>(entry.GetCycles()) / totalCycles : 0.0;
+
+    stream << std::setw(10) << entry.GetCycles() << std::setw(8) << percentage << std::setw(10)
+           << entry.commits << std::setw(10) << entry.stallCycles << std::setw(10)
+           << entry.flushCycles << "  0x" << std::hex << std::setw(8) << std::setfill('0') << pc
+           << std::dec << std::setfill(' ') << "  " << Disassemble(instruction, pc) << '\n';
+}
+
+}
+
+Profiler::Profiler(Emulator const& emulator, Memory const& memory) :
+    _handler { *emulator.GetHandler() },
+    _tracker { emulator },
+    _wbPC { emulator.FindRegister("WB_PC") },
+    _entries(memory.GetTextSize() / 4),
+    _cycles { 0 },
+    _unattributedCycles { 0 }
+{}
+
+void Profiler::OnCycleEnd(Memory const& memory) noexcept
+{
+    PipelineSlot const& slot = _tracker.Advance();
+
+    ++_cycles;
+    if (_handler.CalcNumInstructions(memory))
+    {
+        if (ProfileEntry* entry = Find(memory.GetRegister(_wbPC)))
+        {
+            ++entry->commits;
+            return;
+        }
+    }
+    else if (ProfileEntry* entry = Find(slot.pc))
+    {
+        switch (slot.cause)
+        {
+        case SlotCause::Instruction:
+        case SlotCause::Fill: break;
+        case SlotCause::LoadUse:
+        case SlotCause::Memory: ++entry->stallCycles; return;
+        case SlotCause::Jump:
+        case SlotCause::Branch:
+        case SlotCause::Misprediction: ++entry->flushCycles; return;
+        }
+    }
+
+    ++_unattributedCycles;
+}
+
+void Profiler::WriteFlatProfile(Memory const& memory, std::ostream& stream) const
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < _entries.size(); ++i)
+    {
+        if (_entries[i].GetCycles())
+            indices.push_back(i);
+    }
+
+    std::stable_sort(indices.begin(), indices.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return _entries[lhs].GetCycles() > _entries[rhs].GetCycles();
+    });
+
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    stream << "Flat profile (" << _cycles << " cycles, " << _unattributedCycles
+           << " not attributed):\n";
+    WriteHeader(stream);
+    for (uint32_t idx : indices)
+    {
+        uint32_t const pc = TextBase + idx * 4;
+        WriteEntry(_entries[idx], _cycles, pc, memory.GetWord(Address::MakeText(idx * 4)), stream);
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void Profiler::WriteAnnotatedListing(Memory const& memory, std::ostream& stream) const
+{
+    auto const flags     = stream.flags();
+    auto const precision = stream.precision();
+    stream << std::fixed << std::setprecision(2);
+
+    stream << "Annotated listing:\n";
+    WriteHeader(stream);
+    for (uint32_t idx = 0; idx < _entries.size(); ++idx)
+    {
+        uint32_t const pc = TextBase + idx * 4;
+        WriteEntry(_entries[idx], _cycles, pc, memory.GetWord(Address::MakeText(idx * 4)), stream);
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+ProfileEntry* Profiler::Find(uint32_t pc) noexcept
+{
+    uint32_t const idx = (pc - TextBase) / 4;
+    if (pc < TextBase || idx >= _entries.size())
+        return nullptr;
+    return &_entries[idx];
+}
@@ -0,0 +1,235 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/Elf.hh>
+#include <pip-mips-emu/ProgramCache.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <optional>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr char ImageExtension[]     = ".pmeb";
+constexpr char TemporaryExtension[] = ".tmp";
+
+/// <summary>
+/// Seed of the content hash. Must be changed whenever the format of the images changes, so that
+/// stale images are not read.
+/// </summary>
+constexpr uint64_t KeySeed = BinaryFileVersion;
+
+/// <summary>
+/// Read-only stream buffer over bytes in memory
+/// </summary>
+class MemoryStreamBuffer : public std::streambuf
+{
+  public:
+    MemoryStreamBuffer(char* begin, char* end) noexcept
+    {
+        setg(begin, begin, end);
+    }
+};
+
+std::optional<std::vector<char>> ReadAll(fs::path const& path)
+{
+    std::error_code ec;
+    auto const      size = fs::file_size(path, ec);
+    if (ec)
+        return std::nullopt;
+
+    std::ifstream ifs { path, std::ios::binary };
+    if (!ifs)
+        return std::nullopt;
+
+    std::vector<char> rtn(static_cast<size_t>(size));
+    if (!ifs.read(rtn.data(), static_cast<std::streamsize>(rtn.size())))
+        return std::nullopt;
+
+    return rtn;
+}
+
+bool HasMagic(std::vector<char> const& bytes, char const (&magic)[4]) noexcept
+{
+    return bytes.size() >= sizeof(magic) && std::memcmp(bytes.data(), magic, sizeof(magic)) == 0;
+}
+
+std::string FormatKey(uint64_t key)
+{
+    constexpr char digits[] = "0123456789abcdef";
+
+    std::string rtn(16, '0');
+    for (size_t i = 0; i < 16; ++i) rtn[15 - i] = digits[(key >> (i * 4)) & 0xF];
+    return rtn;
+}
+
+}
+
+ProgramCache::ProgramCache(ProgramCacheConfig config) : _config { std::move(config) } {}
+
+FileReadResult ProgramCache::Read(fs::path const& path)
+{
+    std::optional<std::vector<char>> contents = ReadAll(path);
+    if (!contents || HasMagic(*contents, BinaryFileMagic) || HasMagic(*contents, ElfFileMagic))
+        return ReadFile(path);
+
+    uint64_t const key       = Hash64(contents->data(), contents->size(), KeySeed);
+    fs::path const imagePath = _config.directory / (FormatKey(key) + ImageExtension);
+
+    std::error_code ec;
+    if (fs::is_regular_file(imagePath, ec))
+    {
+        FileReadResult result = ReadFile(imagePath);
+        if (std::holds_alternative<CanRead>(result))
+        {
+            ++_stats.hits;
+
+            // The modification time is used as the time of the last use
+            fs::last_write_time(imagePath, fs::file_time_type::clock::now(), ec);
+            return result;
+        }
+
+        fs::remove(imagePath, ec);
+    }
+
+    ++_stats.misses;
+
+    // The contents already read are parsed, so that the image matches the key even if the file is
+    // modified in the meantime
+    MemoryStreamBuffer buffer { contents->data(), contents->data() + contents->size() };
+    std::istream       is { &buffer };
+
+    FileReadResult result = ReadFile(is);
+    if (std::holds_alternative<CannotRead>(result))
+        return ReadFile(path);
+
+    try
+    {
+        Store(imagePath, std::get<CanRead>(result));
+    }
+    catch (...)
+    {
+        // Failures of the cache are not reported
+    }
+
+    return result;
+}
+
+fs::path ProgramCache::GetDefaultDirectory()
+{
+    if (char const* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+        return fs::path { cacheHome } / "pip-mips-emu";
+
+    if (char const* home = std::getenv("HOME"); home && *home)
+        return fs::path { home } / ".cache" / "pip-mips-emu";
+
+    if (char const* localAppData = std::getenv("LOCALAPPDATA"); localAppData && *localAppData)
+        return fs::path { localAppData } / "pip-mips-emu";
+
+    return fs::path {};
+}
+
+void ProgramCache::Store(fs::path const& imagePath, CanRead const& file)
+{
+    uint64_t const imageSize = BinaryFileHeaderSize + file.text.size() + file.data.size();
+    if (imageSize > _config.maxSize)
+        return;
+
+    std::error_code ec;
+    fs::create_directories(_config.directory, ec);
+    if (ec)
+        return;
+
+    // Concurrent writers use different temporary files, and the last rename wins. Since images
+    // with the same key have the same contents, readers always see a complete image.
+    std::random_device random;
+    fs::path           temporaryPath = imagePath;
+    temporaryPath += '.' + FormatKey(static_cast<uint64_t>(random()) << 32 | random());
+    temporaryPath += TemporaryExtension;
+
+    {
+        std::ofstream ofs { temporaryPath, std::ios::binary };
+        if (!ofs)
+            return;
+
+        WriteBinaryFile(file, ofs);
+        if (!ofs.flush())
+        {
+            ofs.close();
+            fs::remove(temporaryPath, ec);
+            return;
+        }
+    }
+
+    fs::rename(temporaryPath, imagePath, ec);
+    if (ec)
+    {
+        fs::remove(temporaryPath, ec);
+        return;
+    }
+
+    ++_stats.stores;
+    Trim();
+}
+
+void ProgramCache::Trim()
+{
+    struct Image
+    {
+        fs::path           path;
+        fs::file_time_type lastUse;
+        uint64_t           size;
+    };
+
+    std::vector<Image> images;
+    uint64_t           totalSize = 0;
+
+    std::error_code        ec;
+    fs::directory_iterator it { _config.directory, ec };
+    for (; !ec && it != fs::directory_iterator {}; it.increment(ec))
+    {
+        if (it->path().extension() != ImageExtension)
+            continue;
+
+        std::error_code entryEc;
+        uint64_t const  size    = it->file_size(entryEc);
+        auto const      lastUse = it->last_write_time(entryEc);
+        if (entryEc)
+            continue;
+
+        images.push_back(Image { it->path(), lastUse, size });
+        totalSize += size;
+    }
+
+    if (totalSize <= _config.maxSize)
+        return;
+
+    std::sort(images.begin(), images.end(), [](Image const& lhs, Image const& rhs) {
+        return lhs.lastUse < rhs.lastUse;
+    });
+
+    for (Image const& image : images)
+    {
+        if (totalSize <= _config.maxSize)
+            break;
+
+        // Another process may have removed the image already
+        fs::remove(image.path, ec);
+        if (!ec)
+        {
+            totalSize -= image.size;
+            ++_stats.evictions;
+        }
+    }
+}
@@ -0,0 +1,401 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Common.hh>
+#include <pip-mips-emu/Dump.hh>
+#include <pip-mips-emu/Trace.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr uint32_t DumpPCsFlag       = 0b001;
+constexpr uint32_t DumpRegistersFlag = 0b010;
+constexpr uint32_t RangeFlag         = 0b100;
+
+/// <summary>
+/// Number of bytes buffered before the records are written to the stream
+/// </summary>
+constexpr size_t FlushThreshold = 1 << 16;
+
+/// <summary>
+/// State of a cycle rebuilt from a trace
+/// </summary>
+struct DecodedCycle
+{
+    TraceDecodeMode       mode;
+    uint32_t              flags;
+    Range                 range;
+    uint32_t              cycle;
+    Handler::PCs          pcs;
+    std::vector<uint32_t> registers;
+    std::vector<uint32_t> words;
+
+    // Keys of the registers and the words recorded in the current cycle
+    std::vector<uint32_t> changedRegisters, changedWords;
+};
+
+void WriteCycleHeader(DecodedCycle const& state, TextBuffer& buffer)
+{
+    buffer.Append("===== Cycle ");
+    buffer.AppendDecimal(state.cycle);
+    buffer.Append(" =====\n");
+
+    if (state.flags & DumpPCsFlag)
+    {
+        WritePCs(state.pcs, buffer);
+        buffer.Append('\n');
+    }
+}
+
+void WriteSnapshot(DecodedCycle const& state, TextBuffer& buffer)
+{
+    WriteCycleHeader(state, buffer);
+
+    if (state.flags & DumpRegistersFlag)
+    {
+        WriteRegisters(state.registers[NumDumpedRegisters], state.registers.data(), buffer);
+        buffer.Append('\n');
+        if (state.flags & RangeFlag)
+        {
+            WriteMemoryHeader(state.range, buffer);
+            WriteMemoryWords(state.range.begin, state.words.data(), state.words.size(), buffer);
+            buffer.Append('\n');
+        }
+    }
+}
+
+void WriteChanges(DecodedCycle const& state, TextBuffer& buffer)
+{
+    WriteCycleHeader(state, buffer);
+
+    if (!state.changedRegisters.empty())
+    {
+        buffer.Append("Changed registers:\n");
+        for (uint32_t idx : state.changedRegisters)
+        {
+            if (idx == NumDumpedRegisters)
+            {
+                buffer.Append("PC");
+            }
+            else
+            {
+                buffer.Append('R');
+                buffer.AppendDecimal(idx);
+            }
+            buffer.Append(": 0x");
+            buffer.AppendHex(state.registers[idx]);
+            buffer.Append('\n');
+        }
+        buffer.Append('\n');
+    }
+
+    if (!state.changedWords.empty())
+    {
+        buffer.Append("Changed memory:\n");
+        for (uint32_t idx : state.changedWords)
+        {
+            uint32_t const address = static_cast<uint32_t>(state.range.begin) + idx * 4;
+            WriteMemoryWords(Address::MakeFromWord(address), &state.words[idx], 1, buffer);
+        }
+        buffer.Append('\n');
+    }
+}
+
+void WriteCycle(DecodedCycle& state, TextBuffer& buffer)
+{
+    if (state.mode == TraceDecodeMode::Changes)
+        WriteChanges(state, buffer);
+    else
+        WriteSnapshot(state, buffer);
+
+    state.changedRegisters.clear();
+    state.changedWords.clear();
+}
+
+}
+
+TraceWriter::TraceWriter(std::ostream& stream, TraceConfig const& config) :
+    TraceWriter { &stream, nullptr, config }
+{}
+
+TraceWriter::TraceWriter(AsyncWriter& writer, TraceConfig const& config) :
+    TraceWriter { nullptr, &writer, config }
+{
+    if (!Flush())
+        throw std::runtime_error { "Cannot queue the trace header" };
+}
+
+TraceWriter::TraceWriter(std::ostream* stream, AsyncWriter* writer, TraceConfig const& config) :
+    _stream { stream },
+    _asyncWriter { writer },
+    _config { config },
+    _registers(NumDumpedRegisters + 1, 0),
+    _bufferSize { 0 },
+    _hasSnapshot { false },
+    _resync { false }
+{
+    if (!_config.dumpRegisters)
+        _config.range = std::nullopt;
+
+    if (_config.range)
+    {
+        size_t const numWords = CountMemoryWords(_config.range.value());
+        _words.resize(numWords, 0);
+        _currentWords.resize(numWords, 0);
+    }
+
+    uint32_t flags = 0;
+    Range    range { Address::MakeText(0), Address::MakeText(0) };
+    if (_config.dumpPCs)
+        flags |= DumpPCsFlag;
+    if (_config.dumpRegisters)
+        flags |= DumpRegistersFlag;
+    if (_config.range)
+    {
+        flags |= RangeFlag;
+        range = _config.range.value();
+    }
+
+    char header[TraceFileHeaderSize];
+    std::memcpy(header, TraceFileMagic, sizeof(TraceFileMagic));
+    PutLittleEndianWord(header + 4, TraceFileVersion);
+    PutLittleEndianWord(header + 8, flags);
+    PutLittleEndianWord(header + 12, range.begin);
+    PutLittleEndianWord(header + 16, range.end);
+    _buffer.assign(std::begin(header), std::end(header));
+    _bufferSize = sizeof(header);
+}
+
+void TraceWriter::WriteCycle(uint32_t cycle, Memory const& memory, Handler& handler)
+{
+    BeginCycle(cycle, memory, handler, _registers.size() + _words.size());
+
+    if (_config.dumpRegisters)
+    {
+        for (uint32_t idx = 0; idx <= NumDumpedRegisters; ++idx) AppendRegister(memory, idx);
+    }
+
+    if (_config.range)
+    {
+        ReadMemoryWords(memory, _config.range.value(), _currentWords.data());
+        for (size_t i = 0; i < _words.size(); ++i)
+        {
+            if (_resync || _currentWords[i] != _words[i])
+                Append(TraceRecordType::Memory, static_cast<uint32_t>(i), _currentWords[i]);
+        }
+        _words.swap(_currentWords);
+    }
+
+    _hasSnapshot = true;
+    EndCycle();
+}
+
+void TraceWriter::WriteCycle(uint32_t             cycle,
+                             Memory const&        memory,
+                             Handler&             handler,
+                             AppliedWrites const& writes)
+{
+    // The locations not written since the last snapshot are compared only in a full cycle
+    if (_resync || !_hasSnapshot)
+    {
+        WriteCycle(cycle, memory, handler);
+        return;
+    }
+
+    BeginCycle(cycle, memory, handler, writes.registers.size() + 2 * writes.addresses.size());
+
+    if (_config.dumpRegisters)
+    {
+        for (uint32_t idx : writes.registers) AppendRegister(memory, idx);
+    }
+
+    if (_config.range)
+    {
+        Range const    range = _config.range.value();
+        uint32_t const begin = range.begin;
+        uint32_t const end   = range.end;
+        for (uint32_t address : writes.addresses)
+        {
+            // Words in the range are not aligned if the range is not, so a written word can
+            // overlap two of them
+            uint64_t const first = std::max<uint64_t>(address, uint64_t { begin } + 3) - 3;
+            uint64_t const last  = std::min<uint64_t>(uint64_t { address } + 3, end);
+            if (first > last)
+                continue;
+
+            size_t const firstIdx = static_cast<size_t>((first - begin + 3) / 4);
+            size_t const lastIdx  = static_cast<size_t>((last - begin) / 4);
+            for (size_t i = firstIdx; i <= lastIdx; ++i)
+            {
+                Address const wordAddress
+                    = Address::MakeFromWord(static_cast<uint32_t>(begin + i * 4));
+                uint32_t word;
+                ReadMemoryWords(memory, Range { wordAddress, wordAddress }, &word);
+                if (word != _words[i])
+                {
+                    Append(TraceRecordType::Memory, static_cast<uint32_t>(i), word);
+                    _words[i] = word;
+                }
+            }
+        }
+    }
+
+    EndCycle();
+}
+
+bool TraceWriter::Flush()
+{
+    bool written = true;
+    if (_stream)
+        _stream->write(_buffer.data(), static_cast<std::streamsize>(_bufferSize));
+    else
+        written = _asyncWriter->Write(_buffer.data(), _bufferSize);
+    _bufferSize = 0;
+
+    // The dropped records may contain changes which are not written again
+    if (!written)
+        _resync = true;
+    return written;
+}
+
+void TraceWriter::BeginCycle(uint32_t      cycle,
+                             Memory const& memory,
+                             Handler&      handler,
+                             size_t        numChanges)
+{
+    Reserve(1 + Handler::NumStages + numChanges);
+    Append(TraceRecordType::Cycle, cycle, 0);
+
+    if (_config.dumpPCs)
+    {
+        Handler::PCs const pcs = handler.GetPCs(memory);
+        for (uint32_t i = 0; i < Handler::NumStages; ++i) Append(TraceRecordType::PC, i, pcs[i]);
+    }
+}
+
+void TraceWriter::EndCycle()
+{
+    _resync = false;
+    if (_bufferSize >= FlushThreshold)
+        Flush();
+}
+
+void TraceWriter::AppendRegister(Memory const& memory, uint32_t idx)
+{
+    uint32_t value = memory.GetRegister(idx);
+    if (idx == NumDumpedRegisters)
+        value = std::min(value, static_cast<uint32_t>(Address::MakeText(memory.GetTextSize())));
+
+    if (_resync || value != _registers[idx])
+    {
+        Append(TraceRecordType::Register, idx, value);
+        _registers[idx] = value;
+    }
+}
+
+void TraceWriter::Reserve(size_t numRecords)
+{
+    size_t const required = _bufferSize + numRecords * TraceRecordSize;
+    if (_buffer.size() < required)
+        _buffer.resize(required);
+}
+
+void TraceWriter::Append(TraceRecordType type, uint32_t key, uint32_t value) noexcept
+{
+    char* ptr = _buffer.data() + _bufferSize;
+    PutLittleEndianWord(ptr + 0, static_cast<uint32_t>(type));
+    PutLittleEndianWord(ptr + 4, key);
+    PutLittleEndianWord(ptr + 8, value);
+    _bufferSize += TraceRecordSize;
+}
+
+void DecodeTrace(std::istream& is, std::ostream& os, TraceDecodeMode mode)
+{
+    char header[TraceFileHeaderSize];
+    if (!is.read(header, sizeof(header))
+        || std::memcmp(header, TraceFileMagic, sizeof(TraceFileMagic)) != 0)
+        throw std::runtime_error { "Invalid trace" };
+
+    if (GetLittleEndianWord(header + 4) != TraceFileVersion)
+        throw std::runtime_error { "Unsupported trace version" };
+
+    DecodedCycle state {
+        mode,
+        GetLittleEndianWord(header + 8),
+        Range {
+            Address::MakeFromWord(GetLittleEndianWord(header + 12)),
+            Address::MakeFromWord(GetLittleEndianWord(header + 16)),
+        },
+        0,
+        Handler::PCs {},
+        std::vector<uint32_t>(NumDumpedRegisters + 1, 0),
+        std::vector<uint32_t> {},
+        std::vector<uint32_t> {},
+        std::vector<uint32_t> {},
+    };
+    if (state.flags & RangeFlag)
+    {
+        if (static_cast<uint32_t>(state.range.begin) > static_cast<uint32_t>(state.range.end))
+            throw std::runtime_error { "Invalid trace" };
+        state.words.resize(CountMemoryWords(state.range), 0);
+    }
+
+    bool       hasCycle = false;
+    TextBuffer text { os };
+
+    std::vector<char> buffer(TraceRecordSize * 4096);
+    while (is)
+    {
+        is.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+        size_t const numBytes = static_cast<size_t>(is.gcount());
+        if (numBytes % TraceRecordSize != 0)
+            throw std::runtime_error { "Truncated trace" };
+
+        for (char const* ptr = buffer.data(); ptr != buffer.data() + numBytes;
+             ptr += TraceRecordSize)
+        {
+            uint32_t const type  = GetLittleEndianWord(ptr + 0);
+            uint32_t const key   = GetLittleEndianWord(ptr + 4);
+            uint32_t const value = GetLittleEndianWord(ptr + 8);
+
+            if (type == static_cast<uint32_t>(TraceRecordType::Cycle))
+            {
+                if (hasCycle)
+                    WriteCycle(state, text);
+                hasCycle    = true;
+                state.cycle = key;
+                continue;
+            }
+
+            if (!hasCycle)
+                throw std::runtime_error { "Invalid trace record" };
+
+            if (type == static_cast<uint32_t>(TraceRecordType::PC) && key < state.pcs.size())
+                state.pcs[key] = value;
+            else if (type == static_cast<uint32_t>(TraceRecordType::Register)
+                     && key < state.registers.size())
+            {
+                state.registers[key] = value;
+                state.changedRegisters.push_back(key);
+            }
+            else if (type == static_cast<uint32_t>(TraceRecordType::Memory)
+                     && key < state.words.size())
+            {
+                state.words[key] = value;
+                state.changedWords.push_back(key);
+            }
+            else
+                throw std::runtime_error { "Invalid trace record" };
+        }
+    }
+
+    if (hasCycle)
+        WriteCycle(state, text);
+}
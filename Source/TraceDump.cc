@@ -0,0 +1,38 @@
+// Copyright (c) 2021 Chanjung Kim (paxbun). All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Trace.hh>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Prints the text runfile prints for each cycle, from a trace written with '-trace'. With
+// '-changes', only the registers and words which changed in each cycle are printed.
+// Usage: tracedump [-changes] <trace>
+int main(int argc, char* argv[])
+{
+    try
+    {
+        std::ios::sync_with_stdio(false);
+
+        TraceDecodeMode mode = TraceDecodeMode::Snapshots;
+        if (argc == 3 && strcmp(argv[1], "-changes") == 0)
+            mode = TraceDecodeMode::Changes;
+        else if (argc != 2)
+            throw std::runtime_error { "Usage: tracedump [-changes] <trace>" };
+
+        std::ifstream ifs { argv[argc - 1], std::ios::binary };
+        if (!ifs)
+            throw std::runtime_error { "File does not exist" };
+
+        DecodeTrace(ifs, std::cout, mode);
+        return 0;
+    }
+    catch (std::exception const& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+}
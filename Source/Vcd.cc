@@ -0,0 +1,180 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/Vcd.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr uint32_t RegisterWidth = 32;
+constexpr uint32_t SignalWidth   = 16;
+
+// Identifiers consist of the printable characters from '!' to '~'
+constexpr uint32_t FirstIdChar = '!';
+constexpr uint32_t NumIdChars  = '~' - '!' + 1;
+
+std::string MakeId(uint32_t idx)
+{
+    std::string rtn;
+    do
+    {
+        rtn.push_back(static_cast<char>(FirstIdChar + idx % NumIdChars));
+        idx /= NumIdChars;
+    } while (idx != 0);
+    return rtn;
+}
+
+bool MatchesAny(std::vector<std::string> const& patterns, std::string const& name)
+{
+    if (patterns.empty())
+        return true;
+
+    return std::any_of(patterns.begin(), patterns.end(), [&](std::string const& pattern) {
+        return VcdWriter::Matches(pattern, name);
+    });
+}
+
+}
+
+VcdWriter::VcdWriter(std::ostream& stream, Emulator const& emulator, VcdConfig const& config) :
+    _controls(emulator.GetNamedSignals().size(), 0), _cycle { 0 }, _buffer { stream }
+{
+    auto collect = [&](std::unordered_map<std::string, uint32_t> const& entries,
+                       uint32_t                                         width,
+                       std::vector<Variable>&                           variables) {
+        for (auto const& [name, index] : entries)
+        {
+            if (MatchesAny(config.patterns, name))
+                variables.push_back(Variable { name, {}, index, width, 0 });
+        }
+
+        std::sort(variables.begin(), variables.end(), [](auto const& lhs, auto const& rhs) {
+            return lhs.name < rhs.name;
+        });
+    };
+
+    collect(emulator.GetNamedRegisters(), RegisterWidth, _registers);
+    collect(emulator.GetNamedSignals(), SignalWidth, _signals);
+
+    if (_registers.empty() && _signals.empty())
+        throw std::invalid_argument { "No register or signal matches the patterns" };
+
+    uint32_t numVariables = 0;
+    for (auto* variables : { &_registers, &_signals })
+    {
+        for (auto& variable : *variables) variable.id = MakeId(numVariables++);
+    }
+
+    _buffer.Append("$version pip-mips-emu $end\n");
+    _buffer.Append("$timescale 1ns $end\n");
+    _buffer.Append("$scope module pipeline $end\n");
+    for (auto* variables : { &_registers, &_signals })
+    {
+        for (auto const& variable : *variables)
+        {
+            _buffer.Append(variables == &_registers ? "$var reg " : "$var wire ");
+            _buffer.AppendDecimal(variable.width);
+            _buffer.Append(' ');
+            _buffer.Append(variable.id);
+            _buffer.Append(' ');
+            _buffer.Append(variable.name);
+            _buffer.Append(" $end\n");
+        }
+    }
+    _buffer.Append("$upscope $end\n");
+    _buffer.Append("$enddefinitions $end\n");
+}
+
+bool VcdWriter::Matches(std::string_view pattern, std::string_view name) noexcept
+{
+    // Backtracks to the last '*' on a mismatch
+    size_t p = 0, n = 0;
+    size_t starP = std::string_view::npos, starN = 0;
+    while (n < name.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+        {
+            ++p;
+            ++n;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starP = p++;
+            starN = n;
+        }
+        else if (starP != std::string_view::npos)
+        {
+            p = starP + 1;
+            n = ++starN;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+void VcdWriter::OnControlsResolved(Memory const&, std::vector<uint16_t> const& controls)
+{
+    _controls = controls;
+}
+
+void VcdWriter::OnCycleEnd(Memory const& memory)
+{
+    bool const initial = _cycle++ == 0;
+    bool       stamped = false;
+
+    auto update = [&](Variable& variable, uint32_t value) {
+        if (!initial && variable.value == value)
+            return;
+
+        if (!stamped)
+        {
+            _buffer.Append('#');
+            _buffer.AppendDecimal(_cycle);
+            _buffer.Append(initial ? "\n$dumpvars\n" : "\n");
+            stamped = true;
+        }
+
+        variable.value = value;
+        AppendValue(variable);
+    };
+
+    for (auto& variable : _registers) update(variable, memory.GetRegister(variable.index));
+    for (auto& variable : _signals) update(variable, _controls[variable.index]);
+
+    if (initial)
+        _buffer.Append("$end\n");
+}
+
+void VcdWriter::Flush()
+{
+    _buffer.Flush();
+}
+
+void VcdWriter::AppendValue(Variable const& variable)
+{
+    // Vectors are written in binary without leading zeros
+    char     digits[RegisterWidth + 1];
+    uint32_t size  = 0;
+    uint32_t value = variable.value;
+    digits[size++] = 'b';
+    for (int bit = RegisterWidth - 1; bit >= 0; --bit)
+    {
+        if (size > 1 || (value >> bit) & 1)
+            digits[size++] = static_cast<char>('0' + ((value >> bit) & 1));
+    }
+    if (size == 1)
+        digits[size++] = '0';
+
+    _buffer.Append(std::string_view { digits, size });
+    _buffer.Append(' ');
+    _buffer.Append(variable.id);
+    _buffer.Append('\n');
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <pip-mips-emu/WriteBuffer.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+WriteBuffer::WriteBuffer(WriteBufferConfig const& config, MemoryLevelPtr next) :
+    _config { config },
+    _next { std::move(next) }
+{
+    if (_config.numEntries == 0)
+        throw std::invalid_argument { "write buffer must have at least one entry" };
+
+    _entries.resize(_config.numEntries);
+    Reset();
+}
+
+uint32_t WriteBuffer::Access(uint32_t address, AccessType type) noexcept
+{
+    uint32_t const wordAddress = address & ~static_cast<uint32_t>(0b11);
+
+    if (type == AccessType::Read)
+    {
+        ++_stats.loads;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            if (At(i).wordAddress == wordAddress)
+            {
+                ++_stats.forwardedLoads;
+                return 0;
+            }
+        }
+
+        return _next ? _next->Access(address, type) : 0;
+    }
+
+    ++_stats.stores;
+
+    uint32_t stall = 0;
+    if (_size == _entries.size())
+    {
+        // The oldest store retires while the pipeline waits
+        stall = static_cast<uint32_t>(At(0).retireCycle - _cycle);
+        ++_stats.fullStalls;
+        _stats.fullStallCycles += stall;
+
+        _head = (_head + 1) % _entries.size();
+        --_size;
+    }
+
+    // Stores are retired one at a time
+    uint64_t       start   = _cycle + stall;
+    uint32_t const latency = _next ? _next->Access(address, type) : _config.drainCycles;
+    if (_size)
+        start = std::max(start, At(_size - 1).retireCycle);
+
+    ++_size;
+    At(_size - 1)       = Entry { start + latency, wordAddress };
+    _stats.maxOccupancy = std::max(_stats.maxOccupancy, static_cast<uint32_t>(_size));
+
+    return stall;
+}
+
+void WriteBuffer::Tick() noexcept
+{
+    ++_cycle;
+    Retire();
+
+    if (_next)
+        _next->Tick();
+}
+
+void WriteBuffer::Reset() noexcept
+{
+    _head  = 0;
+    _size  = 0;
+    _cycle = 0;
+    _stats = WriteBufferStats {};
+}
+
+void WriteBuffer::Retire() noexcept
+{
+    while (_size && At(0).retireCycle <= _cycle)
+    {
+        _head = (_head + 1) % _entries.size();
+        --_size;
+    }
+}
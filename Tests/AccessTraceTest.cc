@@ -0,0 +1,158 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/AccessTrace.hh>
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include "TestCommon.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Small caches which miss on the first access to each line
+CacheConfig MakeCacheConfig()
+{
+    CacheConfig config;
+    config.size        = 64;
+    config.lineSize    = 16;
+    config.missPenalty = 3;
+    return config;
+}
+
+class AccessTraceTest : public testing::Test
+{
+  protected:
+    std::filesystem::path _path;
+
+  protected:
+    void SetUp() override
+    {
+        _path = std::filesystem::temp_directory_path() / "pip-mips-emu-access-trace-test.pma";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(_path);
+    }
+
+    void Run(MemoryLevelPtr instructionLevel, MemoryLevelPtr dataLevel)
+    {
+        auto [emulator, memory] = BuildFibonacci(instructionLevel, dataLevel);
+
+        AsyncWriter file { _path, AsyncWriterConfig { 64, OverflowPolicy::Block } };
+        {
+            AccessTraceWriter writer { file };
+
+            uint32_t numInstructions = 0;
+            while (!emulator.IsTerminated(memory))
+            {
+                ASSERT_EQ(emulator.TickTock(memory, numInstructions, writer),
+                          TickTockResult::Success);
+            }
+            writer.Flush();
+        }
+        file.Close();
+    }
+};
+
+}
+
+TEST_F(AccessTraceTest, Records)
+{
+    Run(nullptr, nullptr);
+
+    std::ifstream             ifs { _path, std::ios::binary };
+    AccessTraceReader         reader { ifs };
+    std::vector<AccessRecord> records;
+    for (AccessRecord record; reader.Next(record);) records.push_back(record);
+
+    // Without stalls, an instruction is fetched every cycle until the text segment ends
+    ASSERT_GE(records.size(), 2);
+    EXPECT_EQ(records[0].kind, AccessKind::Fetch);
+    EXPECT_EQ(records[0].cycle, 1);
+    EXPECT_EQ(records[0].pc, 0x400000);
+    EXPECT_EQ(records[0].address, 0x400000);
+    EXPECT_EQ(records[1].cycle, 2);
+    EXPECT_EQ(records[1].pc, 0x400004);
+
+    // The first LW reads the first element in MEM, 3 cycles after it is fetched
+    auto load = std::find_if(records.begin(), records.end(), [](AccessRecord const& record) {
+        return record.kind == AccessKind::Load;
+    });
+    ASSERT_NE(load, records.end());
+    EXPECT_EQ(load->pc, 0x400010);
+    EXPECT_EQ(load->address, 0x10000000);
+    EXPECT_EQ(load->size, 4);
+    EXPECT_EQ(load->cycle, 8);
+
+    // Each of the 8 iterations loads 2 elements and stores 1
+    size_t loads = 0, stores = 0;
+    for (auto const& record : records)
+    {
+        loads += record.kind == AccessKind::Load;
+        stores += record.kind == AccessKind::Store;
+    }
+    EXPECT_EQ(loads, 16);
+    EXPECT_EQ(stores, 8);
+}
+
+TEST_F(AccessTraceTest, ReplayMatchesEmulation)
+{
+    auto instructionCache = std::make_shared<Cache>(MakeCacheConfig());
+    auto dataCache        = std::make_shared<Cache>(MakeCacheConfig());
+    Run(instructionCache, dataCache);
+
+    Cache instructionReplay { MakeCacheConfig() }, dataReplay { MakeCacheConfig() };
+
+    std::ifstream           ifs { _path, std::ios::binary };
+    AccessReplayStats const stats = ReplayAccessTrace(ifs, &instructionReplay, &dataReplay);
+    EXPECT_EQ(stats.loads, 16);
+    EXPECT_EQ(stats.stores, 8);
+
+    auto const expectEqual = [](CacheStats const& replayed, CacheStats const& emulated) {
+        EXPECT_EQ(replayed.readHits, emulated.readHits);
+        EXPECT_EQ(replayed.readMisses, emulated.readMisses);
+        EXPECT_EQ(replayed.writeHits, emulated.writeHits);
+        EXPECT_EQ(replayed.writeMisses, emulated.writeMisses);
+        EXPECT_EQ(replayed.writeBacks, emulated.writeBacks);
+    };
+    EXPECT_GT(instructionCache->GetStats().readMisses, 0);
+    expectEqual(instructionReplay.GetStats(), instructionCache->GetStats());
+    expectEqual(dataReplay.GetStats(), dataCache->GetStats());
+    EXPECT_EQ(stats.fetches, instructionCache->GetStats().GetAccesses());
+    EXPECT_EQ(stats.instructionStallCycles, instructionCache->GetStats().readMisses * 3);
+}
+
+TEST_F(AccessTraceTest, InvalidTrace)
+{
+    std::istringstream empty { "" };
+    EXPECT_THROW(AccessTraceReader { empty }, std::runtime_error);
+
+    Run(nullptr, nullptr);
+
+    std::ifstream     ifs { _path, std::ios::binary };
+    std::string const trace { std::istreambuf_iterator<char> { ifs }, {} };
+
+    std::istringstream truncated { trace.substr(0, AccessTraceFileHeaderSize + 2) };
+    AccessTraceReader  reader { truncated };
+    AccessRecord       record;
+    EXPECT_THROW(reader.Next(record), std::runtime_error);
+
+    std::istringstream invalid { trace.substr(0, AccessTraceFileHeaderSize) + '\xFF' };
+    AccessTraceReader  invalidReader { invalid };
+    EXPECT_THROW(invalidReader.Next(record), std::runtime_error);
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Allocations.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include "TestCommon.hh"
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(AllocationsTest, Fibonacci)
+{
+    if (!AllocationCountingEnabled)
+        GTEST_SKIP() << "Allocation counting is not enabled in this build";
+
+    auto [emulator, memory] = BuildFibonacci();
+
+    AllocationProfiler profiler { emulator };
+
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, profiler), TickTockResult::Success);
+
+    EXPECT_EQ(profiler.GetCycles(), 72);
+
+    // The controller and the datapaths return their signals and deltas in vectors
+    EXPECT_GE(profiler.GetCounts(AllocationPhase::Controllers).allocations, 72);
+    EXPECT_GT(profiler.GetCounts(AllocationPhase::TickDatapaths).allocations
+                  + profiler.GetCounts(AllocationPhase::TockDatapaths).allocations,
+              0);
+
+    std::ostringstream oss;
+    profiler.WriteReport(oss);
+    EXPECT_NE(oss.str().find("Allocations of 72 cycles"), std::string::npos);
+    EXPECT_NE(oss.str().find("  tock datapaths\n"), std::string::npos);
+}
+
+TEST(AllocationsTest, Counts)
+{
+    if (!AllocationCountingEnabled)
+        GTEST_SKIP() << "Allocation counting is not enabled in this build";
+
+    AllocationCounts const before = GetAllocationCounts();
+    std::vector<char>      buffer(100);
+    AllocationCounts const after = GetAllocationCounts();
+
+    EXPECT_EQ(after.allocations - before.allocations, 1);
+    EXPECT_EQ(after.bytes - before.bytes, 100);
+}
+
+TEST(AllocationsTest, AlignedCounts)
+{
+    if (!AllocationCountingEnabled)
+        GTEST_SKIP() << "Allocation counting is not enabled in this build";
+
+    struct alignas(64) Line
+    {
+        char bytes[64];
+    };
+
+    AllocationCounts const before = GetAllocationCounts();
+    auto                   line   = std::make_unique<Line>();
+    AllocationCounts const after  = GetAllocationCounts();
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(line.get()) % alignof(Line), 0);
+    EXPECT_EQ(after.allocations - before.allocations, 1);
+    EXPECT_EQ(after.bytes - before.bytes, sizeof(Line));
+}
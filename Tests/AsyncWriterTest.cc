@@ -0,0 +1,144 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/AsyncWriter.hh>
+
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+class AsyncWriterTest : public testing::Test
+{
+  protected:
+    fs::path _path;
+
+  protected:
+    virtual void SetUp() override
+    {
+        _path = fs::temp_directory_path() / "pip-mips-emu-async-writer-test.bin";
+        fs::remove(_path);
+    }
+
+    virtual void TearDown() override
+    {
+        fs::remove(_path);
+    }
+
+    std::string ReadContents()
+    {
+        std::ifstream ifs { _path, std::ios::binary };
+        return std::string { std::istreambuf_iterator<char> { ifs }, {} };
+    }
+};
+
+}
+
+TEST(RingBufferTest, InvalidCapacity)
+{
+    EXPECT_THROW(SpscRingBuffer<char>(0), std::invalid_argument);
+    EXPECT_THROW(SpscRingBuffer<char>(100), std::invalid_argument);
+    EXPECT_NO_THROW(SpscRingBuffer<char>(128));
+}
+
+TEST(RingBufferTest, WrapAround)
+{
+    SpscRingBuffer<int> ring { 8 };
+    int const           items[] { 1, 2, 3, 4, 5, 6 };
+
+    ASSERT_TRUE(ring.TryPush(items, 6));
+    ASSERT_EQ(ring.Peek().second, 6);
+    ring.Pop(4);
+
+    // Not enough space for all of them, so none of them is pushed
+    ASSERT_FALSE(ring.TryPush(items, 7));
+    ASSERT_TRUE(ring.TryPush(items, 6));
+
+    // The items are split at the end of the buffer
+    auto [first, firstCount] = ring.Peek();
+    ASSERT_EQ(firstCount, 4);
+    ASSERT_EQ(std::vector<int>(first, first + firstCount), (std::vector<int> { 5, 6, 1, 2 }));
+    ring.Pop(firstCount);
+
+    auto [second, secondCount] = ring.Peek();
+    ASSERT_EQ(std::vector<int>(second, second + secondCount), (std::vector<int> { 3, 4, 5, 6 }));
+    ring.Pop(secondCount);
+    ASSERT_TRUE(ring.IsEmpty());
+}
+
+TEST(RingBufferTest, Concurrent)
+{
+    constexpr uint32_t NumItems = 1 << 16;
+
+    SpscRingBuffer<uint32_t> ring { 1024 };
+    std::thread              producer { [&]() {
+        for (uint32_t i = 0; i < NumItems; ++i)
+        {
+            while (!ring.TryPush(&i, 1)) std::this_thread::yield();
+        }
+    } };
+
+    uint32_t expected = 0;
+    while (expected != NumItems)
+    {
+        auto [items, count] = ring.Peek();
+        for (size_t i = 0; i < count; ++i) ASSERT_EQ(items[i], expected++);
+        ring.Pop(count);
+    }
+    producer.join();
+}
+
+TEST_F(AsyncWriterTest, Block)
+{
+    std::string expected;
+    {
+        AsyncWriter writer { _path, AsyncWriterConfig { 64, OverflowPolicy::Block } };
+        for (int i = 0; i < 10000; ++i)
+        {
+            std::string const line = std::to_string(i) + '\n';
+            ASSERT_TRUE(writer.Write(line.data(), line.size()));
+            expected += line;
+        }
+
+        // Larger than the ring buffer
+        std::vector<char> block(1000);
+        std::iota(block.begin(), block.end(), '\0');
+        ASSERT_TRUE(writer.Write(block.data(), block.size()));
+        expected.append(block.begin(), block.end());
+
+        writer.Close();
+        ASSERT_EQ(writer.GetStats().writtenBytes, expected.size());
+        ASSERT_EQ(writer.GetStats().droppedBytes, 0);
+    }
+
+    ASSERT_EQ(ReadContents(), expected);
+}
+
+TEST_F(AsyncWriterTest, Drop)
+{
+    AsyncWriter writer { _path, AsyncWriterConfig { 64, OverflowPolicy::Drop } };
+
+    std::vector<char> block(100, 'x');
+    ASSERT_FALSE(writer.Write(block.data(), block.size()));
+    ASSERT_TRUE(writer.Write(block.data(), 10));
+    writer.Close();
+
+    AsyncWriterStats const stats = writer.GetStats();
+    ASSERT_EQ(stats.droppedBytes, 100);
+    ASSERT_EQ(stats.writtenBytes, 10);
+    ASSERT_EQ(ReadContents(), std::string(10, 'x'));
+}
+
+TEST_F(AsyncWriterTest, InvalidPath)
+{
+    EXPECT_THROW(AsyncWriter(_path / "file", AsyncWriterConfig {}), std::runtime_error);
+    EXPECT_THROW(AsyncWriter(_path, AsyncWriterConfig { 100 }), std::invalid_argument);
+}
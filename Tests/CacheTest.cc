@@ -0,0 +1,95 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Cache.hh>
+
+TEST(CacheTest, InvalidConfig)
+{
+    EXPECT_THROW(Cache(CacheConfig { 1000, 1, 32 }), std::invalid_argument);
+    EXPECT_THROW(Cache(CacheConfig { 1024, 1, 2 }), std::invalid_argument);
+    EXPECT_THROW(Cache(CacheConfig { 1024, 0, 32 }), std::invalid_argument);
+    EXPECT_THROW(Cache(CacheConfig { 1024, 3, 32 }), std::invalid_argument);
+    EXPECT_NO_THROW(Cache(CacheConfig { 1024, 32, 32 }));
+}
+
+TEST(CacheTest, DirectMapped)
+{
+    Cache cache { CacheConfig { 256, 1, 16, ReplacementPolicy::LRU, WritePolicy::WriteBack, 7 } };
+
+    ASSERT_EQ(cache.Access(0x10000000, AccessType::Read), 7);
+    ASSERT_EQ(cache.Access(0x1000000C, AccessType::Read), 0);
+    ASSERT_EQ(cache.Access(0x10000010, AccessType::Read), 7);
+
+    // Conflicts with the first line
+    ASSERT_EQ(cache.Access(0x10000100, AccessType::Read), 7);
+    ASSERT_EQ(cache.Access(0x10000004, AccessType::Read), 7);
+
+    CacheStats const& stats = cache.GetStats();
+    ASSERT_EQ(stats.readHits, 1);
+    ASSERT_EQ(stats.readMisses, 4);
+    ASSERT_EQ(stats.GetAccesses(), 5);
+}
+
+TEST(CacheTest, LRU)
+{
+    Cache cache { CacheConfig { 64, 2, 16, ReplacementPolicy::LRU, WritePolicy::WriteBack, 5 } };
+
+    // All of the following addresses are mapped to the set 0
+    ASSERT_EQ(cache.Access(0x000, AccessType::Read), 5);
+    ASSERT_EQ(cache.Access(0x100, AccessType::Read), 5);
+    ASSERT_EQ(cache.Access(0x000, AccessType::Read), 0);
+
+    // 0x100 is the least recently used
+    ASSERT_EQ(cache.Access(0x200, AccessType::Read), 5);
+    ASSERT_EQ(cache.Access(0x000, AccessType::Read), 0);
+    ASSERT_EQ(cache.Access(0x100, AccessType::Read), 5);
+}
+
+TEST(CacheTest, WriteBack)
+{
+    Cache cache { CacheConfig { 32, 1, 16, ReplacementPolicy::LRU, WritePolicy::WriteBack, 5 } };
+
+    ASSERT_EQ(cache.Access(0x00, AccessType::Write), 5);
+    ASSERT_EQ(cache.Access(0x04, AccessType::Write), 0);
+
+    // The dirty line must be written back before it is replaced
+    ASSERT_EQ(cache.Access(0x20, AccessType::Read), 10);
+    ASSERT_EQ(cache.Access(0x40, AccessType::Read), 5);
+
+    CacheStats const& stats = cache.GetStats();
+    ASSERT_EQ(stats.writeMisses, 1);
+    ASSERT_EQ(stats.writeHits, 1);
+    ASSERT_EQ(stats.writeBacks, 1);
+}
+
+TEST(CacheTest, WriteThrough)
+{
+    Cache cache { CacheConfig { 32, 1, 16, ReplacementPolicy::LRU, WritePolicy::WriteThrough, 5 } };
+
+    // Stores neither allocate lines nor make them dirty
+    ASSERT_EQ(cache.Access(0x00, AccessType::Write), 5);
+    ASSERT_EQ(cache.Access(0x00, AccessType::Read), 5);
+    ASSERT_EQ(cache.Access(0x00, AccessType::Write), 5);
+    ASSERT_EQ(cache.Access(0x20, AccessType::Read), 5);
+
+    CacheStats const& stats = cache.GetStats();
+    ASSERT_EQ(stats.writeMisses, 1);
+    ASSERT_EQ(stats.writeHits, 1);
+    ASSERT_EQ(stats.writeBacks, 0);
+}
+
+TEST(CacheTest, Random)
+{
+    Cache cache { CacheConfig { 64, 4, 16, ReplacementPolicy::Random, WritePolicy::WriteBack, 3 } };
+
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(cache.Access(i * 16, AccessType::Read), 3);
+    for (uint32_t i = 0; i < 4; ++i) ASSERT_EQ(cache.Access(i * 16, AccessType::Read), 0);
+
+    ASSERT_EQ(cache.Access(0x40, AccessType::Read), 3);
+    ASSERT_EQ(cache.GetStats().readMisses, 5);
+
+    cache.Reset();
+    ASSERT_EQ(cache.GetStats().GetAccesses(), 0);
+    ASSERT_EQ(cache.Access(0x40, AccessType::Read), 3);
+}
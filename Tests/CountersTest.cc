@@ -0,0 +1,124 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Counters.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+
+namespace
+{
+
+void RunFibonacci(PipelineCounters& counters,
+                  bool              atp,
+                  MemoryLevelPtr    instructionLevel = nullptr,
+                  MemoryLevelPtr    dataLevel        = nullptr)
+{
+    auto [emulator, memory] = BuildFibonacci(instructionLevel, dataLevel, atp);
+
+    CounterCollector collector { emulator };
+    uint32_t         numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, collector), TickTockResult::Success);
+
+    ASSERT_EQ(collector.GetCounters().instructions, numInstructions);
+    counters = collector.GetCounters();
+}
+
+CacheConfig MakeCacheConfig()
+{
+    CacheConfig config;
+    config.size        = 64;
+    config.lineSize    = 16;
+    config.missPenalty = 3;
+    return config;
+}
+
+}
+
+TEST(CountersTest, ATP)
+{
+    PipelineCounters counters;
+    ASSERT_NO_FATAL_FAILURE(RunFibonacci(counters, true));
+    ASSERT_EQ(counters.cycles, 72);
+    ASSERT_EQ(counters.instructions, 52);
+    ASSERT_EQ(counters.fillCycles, 4);
+
+    // Each of the 8 iterations stalls for 'add' after 'lw', and 'bne' is predicted as taken in ID
+    ASSERT_EQ(counters.loadUseStalls, 8);
+    ASSERT_EQ(counters.memoryStalls, 0);
+    ASSERT_EQ(counters.branchFlushes, 8);
+    ASSERT_EQ(counters.jumpFlushes, 0);
+
+    // The bubble inserted by the last prediction is discarded by the misprediction
+    ASSERT_EQ(counters.mispredictionFlushes, 1);
+    ASSERT_EQ(counters.branchFlushCycles, 7);
+    ASSERT_EQ(counters.mispredictionFlushCycles, 1);
+
+    ASSERT_EQ(counters.cycles,
+              counters.instructions + counters.fillCycles + counters.GetStallCycles()
+                  + counters.GetFlushCycles());
+}
+
+TEST(CountersTest, ANTP)
+{
+    PipelineCounters counters;
+    ASSERT_NO_FATAL_FAILURE(RunFibonacci(counters, false));
+    ASSERT_EQ(counters.cycles, 86);
+    ASSERT_EQ(counters.instructions, 52);
+
+    // 'bne' is mispredicted in all iterations but the last one
+    ASSERT_EQ(counters.loadUseStalls, 8);
+    ASSERT_EQ(counters.branchFlushes, 0);
+    ASSERT_EQ(counters.mispredictionFlushes, 7);
+    ASSERT_EQ(counters.mispredictionFlushCycles, 21);
+
+    ASSERT_EQ(counters.cycles,
+              counters.instructions + counters.fillCycles + counters.GetStallCycles()
+                  + counters.GetFlushCycles());
+}
+
+TEST(CountersTest, Caches)
+{
+    PipelineCounters uncached, cached;
+    ASSERT_NO_FATAL_FAILURE(RunFibonacci(uncached, true));
+    ASSERT_NO_FATAL_FAILURE(RunFibonacci(cached,
+                                         true,
+                                         std::make_shared<Cache>(MakeCacheConfig()),
+                                         std::make_shared<Cache>(MakeCacheConfig())));
+
+    // Cache misses only delay the pipeline, so the committed instructions do not change
+    ASSERT_GT(cached.memoryStalls, 0);
+    ASSERT_EQ(cached.instructions, uncached.instructions);
+    ASSERT_GT(cached.cycles, uncached.cycles);
+
+    ASSERT_EQ(cached.cycles,
+              cached.instructions + cached.fillCycles + cached.GetStallCycles()
+                  + cached.GetFlushCycles());
+}
+
+TEST(CountersTest, Json)
+{
+    PipelineCounters counters;
+    counters.cycles        = 10;
+    counters.instructions  = 4;
+    counters.loadUseStalls = 1;
+    counters.jumpFlushes   = 2;
+
+    std::ostringstream oss;
+    WriteCountersJson(counters, oss);
+
+    std::string const json = oss.str();
+    EXPECT_NE(json.find("\"cycles\": 10,"), std::string::npos);
+    EXPECT_NE(json.find("\"cpi\": 2.5,"), std::string::npos);
+    EXPECT_NE(json.find("\"loadUse\": 1,"), std::string::npos);
+    EXPECT_NE(json.find("\"jump\": 2,"), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.substr(json.size() - 2), "}\n");
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Coverage.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+#include <stdexcept>
+
+TEST(CoverageTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    CoverageCollector collector { memory };
+
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, collector), TickTockResult::Success);
+
+    // The loop runs until the last BNE falls through
+    Coverage const& coverage = collector.GetCoverage();
+    EXPECT_EQ(coverage.GetNumWords(), 10);
+    EXPECT_EQ(coverage.Count(CoverageKind::Executed), 10);
+    EXPECT_EQ(coverage.Count(CoverageKind::Branches), 1);
+    EXPECT_TRUE(coverage.Test(CoverageKind::Branches, 9));
+    EXPECT_TRUE(coverage.Test(CoverageKind::Taken, 9));
+    EXPECT_TRUE(coverage.Test(CoverageKind::NotTaken, 9));
+    EXPECT_EQ(coverage.CountBothDirections(), 1);
+}
+
+TEST(CoverageTest, Merge)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    // Stops before the first BNE commits
+    CoverageCollector collector { memory };
+    uint32_t          numInstructions = 0;
+    while (numInstructions < 5)
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, collector), TickTockResult::Success);
+
+    Coverage const& partial = collector.GetCoverage();
+    EXPECT_EQ(partial.Count(CoverageKind::Executed), 5);
+    EXPECT_EQ(partial.Count(CoverageKind::Taken), 0);
+
+    std::stringstream ss;
+    partial.Write(ss);
+    EXPECT_EQ(ss.str().size(), CoverageFileHeaderSize + NumCoverageKinds * 4);
+
+    Coverage merged = Coverage::Read(ss);
+    EXPECT_EQ(merged.GetTextHash(), HashText(memory));
+    EXPECT_EQ(merged.Count(CoverageKind::Executed), 5);
+
+    Coverage other { memory };
+    other.Set(CoverageKind::Executed, 9);
+    other.Set(CoverageKind::NotTaken, 9);
+    merged.Merge(other);
+    EXPECT_EQ(merged.Count(CoverageKind::Executed), 6);
+    EXPECT_EQ(merged.Count(CoverageKind::NotTaken), 1);
+    EXPECT_EQ(merged.CountBothDirections(), 0);
+
+    EXPECT_THROW(merged.Merge(Coverage { 10, 0 }), std::invalid_argument);
+}
+
+TEST(CoverageTest, InvalidFile)
+{
+    std::istringstream empty { "" };
+    EXPECT_THROW(Coverage::Read(empty), std::runtime_error);
+
+    std::stringstream ss;
+    Coverage { 40, 0 }.Write(ss);
+    std::string const file = ss.str();
+
+    std::istringstream truncated { file.substr(0, file.size() - 1) };
+    EXPECT_THROW(Coverage::Read(truncated), std::runtime_error);
+
+    std::istringstream trailing { file + '\0' };
+    EXPECT_THROW(Coverage::Read(trailing), std::runtime_error);
+}
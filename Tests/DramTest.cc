@@ -0,0 +1,64 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Dram.hh>
+
+TEST(DramTest, InvalidConfig)
+{
+    EXPECT_THROW(Dram(DramConfig { 3, 2048 }), std::invalid_argument);
+    EXPECT_THROW(Dram(DramConfig { 4, 1000 }), std::invalid_argument);
+}
+
+TEST(DramTest, OpenPage)
+{
+    Dram dram { DramConfig { 4, 1024, PagePolicy::Open, 3, 2, 5 } };
+
+    // Bank 0, row 0
+    ASSERT_EQ(dram.Access(0x0000, AccessType::Read), 3 + 2);
+    ASSERT_EQ(dram.Access(0x0010, AccessType::Write), 2);
+
+    // Bank 1, row 0
+    ASSERT_EQ(dram.Access(0x0400, AccessType::Read), 3 + 2);
+
+    // Bank 0, row 1
+    ASSERT_EQ(dram.Access(0x1000, AccessType::Read), 5 + 3 + 2);
+    ASSERT_EQ(dram.Access(0x1004, AccessType::Read), 2);
+
+    DramStats const& stats = dram.GetStats();
+    ASSERT_EQ(stats.GetAccesses(), 5);
+    ASSERT_EQ(stats.rowHits, 2);
+    ASSERT_EQ(stats.rowMisses, 2);
+    ASSERT_EQ(stats.rowConflicts, 1);
+    ASSERT_EQ(stats.totalLatency, 5 + 2 + 5 + 10 + 2);
+    ASSERT_DOUBLE_EQ(stats.GetRowHitRate(), 0.4);
+    ASSERT_DOUBLE_EQ(stats.GetAverageLatency(), 24.0 / 5);
+}
+
+TEST(DramTest, ClosedPage)
+{
+    Dram dram { DramConfig { 4, 1024, PagePolicy::Closed, 3, 2, 5 } };
+
+    ASSERT_EQ(dram.Access(0x0000, AccessType::Read), 3 + 2);
+    ASSERT_EQ(dram.Access(0x0010, AccessType::Read), 3 + 2);
+    ASSERT_EQ(dram.Access(0x1000, AccessType::Read), 3 + 2);
+    ASSERT_EQ(dram.GetStats().rowMisses, 3);
+
+    dram.Reset();
+    ASSERT_EQ(dram.GetStats().GetAccesses(), 0);
+}
+
+TEST(DramTest, BehindCache)
+{
+    auto  dram = std::make_shared<Dram>(DramConfig { 4, 1024, PagePolicy::Open, 3, 2, 5 });
+    Cache cache { CacheConfig { 32, 1, 16 }, dram };
+
+    ASSERT_EQ(cache.Access(0x00, AccessType::Write), 3 + 2);
+    ASSERT_EQ(cache.Access(0x04, AccessType::Read), 0);
+
+    // Write-back of the dirty line followed by the fill, both hitting the open row
+    ASSERT_EQ(cache.Access(0x20, AccessType::Read), 2 + 2);
+    ASSERT_EQ(dram->GetStats().GetAccesses(), 3);
+    ASSERT_EQ(dram->GetStats().rowHits, 2);
+}
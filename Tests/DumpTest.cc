@@ -0,0 +1,69 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Dump.hh>
+
+#include <sstream>
+#include <string>
+
+TEST(DumpTest, TextBuffer)
+{
+    std::ostringstream oss;
+    {
+        TextBuffer buffer { oss };
+        buffer.AppendHex(0);
+        buffer.Append(' ');
+        buffer.AppendHex(0xDEADBEEF);
+        buffer.Append(' ');
+        buffer.AppendDecimal(4294967295);
+        buffer.Append('\n');
+
+        // Nothing is written until the buffer is full or flushed
+        ASSERT_TRUE(oss.str().empty());
+        buffer.Flush();
+        ASSERT_EQ(oss.str(), "0 deadbeef 4294967295\n");
+
+        // Text longer than the buffer
+        buffer.Append('a');
+        buffer.Append(std::string(TextBuffer::Capacity * 2, 'b'));
+    }
+    ASSERT_EQ(oss.str().size(), 22 + 1 + TextBuffer::Capacity * 2);
+    ASSERT_EQ(oss.str().substr(22, 3), "abb");
+}
+
+TEST(DumpTest, Format)
+{
+    std::ostringstream oss;
+
+    // The formatting flags of the stream are ignored
+    oss << std::uppercase << std::showbase;
+
+    WritePCs(Handler::PCs { 0x400000, 0, 0x40000c, 0, 0 }, oss);
+    ASSERT_EQ(oss.str(), "Current pipeline PC state:\n{0x400000||0x40000c||}\n");
+
+    oss.str("");
+    uint32_t const words[] { 0xA, 0x0 };
+    WriteMemoryHeader(Range { Address::MakeData(0), Address::MakeData(4) }, oss);
+    WriteMemoryWords(Address::MakeData(0), words, 2, oss);
+    ASSERT_EQ(oss.str(),
+              "Memory content [0x10000000..0x10000004]:\n"
+              "------------------------------------\n"
+              "0x10000000: 0xa\n"
+              "0x10000004: 0x0\n");
+
+    oss.str("");
+    uint32_t registers[NumDumpedRegisters] {};
+    registers[31] = 0x7FFFFFFC;
+    WriteRegisters(0x400010, registers, oss);
+
+    std::string const text = oss.str();
+    ASSERT_EQ(text.find("Current register values:\n"
+                        "------------------------------------\n"
+                        "PC: 0x400010\n"
+                        "Registers:\n"
+                        "R0: 0x0\n"),
+              0);
+    ASSERT_NE(text.find("R10: 0x0\n"), std::string::npos);
+    ASSERT_NE(text.find("R31: 0x7ffffffc\n"), std::string::npos);
+}
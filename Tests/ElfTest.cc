@@ -0,0 +1,165 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Elf.hh>
+
+#include <sstream>
+
+namespace
+{
+
+void PutHalf(std::vector<uint8_t>& bytes, size_t offset, uint16_t value)
+{
+    bytes[offset + 0] = static_cast<uint8_t>(value >> 8);
+    bytes[offset + 1] = static_cast<uint8_t>(value >> 0);
+}
+
+void PutWord(std::vector<uint8_t>& bytes, size_t offset, uint32_t value)
+{
+    bytes[offset + 0] = static_cast<uint8_t>(value >> 24);
+    bytes[offset + 1] = static_cast<uint8_t>(value >> 16);
+    bytes[offset + 2] = static_cast<uint8_t>(value >> 8);
+    bytes[offset + 3] = static_cast<uint8_t>(value >> 0);
+}
+
+// Makes an executable with a text segment of two words, a data segment of three words whose last
+// two words are not stored in the file, and two symbols.
+std::vector<uint8_t> MakeExecutable()
+{
+    std::vector<uint8_t> bytes(312, 0);
+
+    // File header
+    bytes[0] = 0x7F, bytes[1] = 'E', bytes[2] = 'L', bytes[3] = 'F';
+    bytes[4] = 1, bytes[5] = 2, bytes[6] = 1;
+    PutHalf(bytes, 16, 2);
+    PutHalf(bytes, 18, 8);
+    PutWord(bytes, 20, 1);
+    PutWord(bytes, 24, 0x400004);
+    PutWord(bytes, 28, 52);
+    PutWord(bytes, 32, 192);
+    PutHalf(bytes, 40, 52);
+    PutHalf(bytes, 42, 32);
+    PutHalf(bytes, 44, 2);
+    PutHalf(bytes, 46, 40);
+    PutHalf(bytes, 48, 3);
+
+    // Program headers
+    PutWord(bytes, 52 + 0, 1);
+    PutWord(bytes, 52 + 4, 116);
+    PutWord(bytes, 52 + 8, 0x400000);
+    PutWord(bytes, 52 + 16, 8);
+    PutWord(bytes, 52 + 20, 8);
+
+    PutWord(bytes, 84 + 0, 1);
+    PutWord(bytes, 84 + 4, 124);
+    PutWord(bytes, 84 + 8, 0x10000000);
+    PutWord(bytes, 84 + 16, 4);
+    PutWord(bytes, 84 + 20, 12);
+
+    // Segments
+    PutWord(bytes, 116, 0x3C011000);
+    PutWord(bytes, 120, 0x24020001);
+    PutWord(bytes, 124, 0xDEADBEEF);
+
+    // String table
+    char const strings[] = "\0main\0buffer";
+    std::copy(std::begin(strings), std::end(strings), bytes.begin() + 128);
+
+    // Symbol table
+    PutWord(bytes, 160 + 0, 1);
+    PutWord(bytes, 160 + 4, 0x400000);
+    PutWord(bytes, 160 + 8, 8);
+    bytes[160 + 12] = 0x12;
+    PutWord(bytes, 176 + 0, 6);
+    PutWord(bytes, 176 + 4, 0x10000000);
+    PutWord(bytes, 176 + 8, 12);
+    bytes[176 + 12] = 0x11;
+
+    // Section headers
+    PutWord(bytes, 232 + 4, 2);
+    PutWord(bytes, 232 + 16, 144);
+    PutWord(bytes, 232 + 20, 48);
+    PutWord(bytes, 232 + 24, 2);
+    PutWord(bytes, 232 + 36, 16);
+
+    PutWord(bytes, 272 + 4, 3);
+    PutWord(bytes, 272 + 16, 128);
+    PutWord(bytes, 272 + 20, 13);
+
+    return bytes;
+}
+
+}
+
+TEST(ElfTest, Load)
+{
+    std::vector<uint8_t> bytes = MakeExecutable();
+
+    FileReadResult result = ReadElfFile(bytes.data(), bytes.size());
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+
+    CanRead const& file = std::get<CanRead>(result);
+    ASSERT_EQ(file.text, (std::vector<uint8_t> { 0x3C, 0x01, 0x10, 0x00, 0x24, 0x02, 0x00, 0x01 }));
+    ASSERT_EQ(file.data, (std::vector<uint8_t> { 0xDE, 0xAD, 0xBE, 0xEF, 0, 0, 0, 0, 0, 0, 0, 0 }));
+    ASSERT_EQ(file.entryPoint, 0x400004);
+
+    ASSERT_EQ(file.symbols.size(), 2);
+    ASSERT_EQ(file.symbols[0].name, "main");
+    ASSERT_EQ(file.symbols[0].value, 0x400000);
+    ASSERT_EQ(file.symbols[0].size, 8);
+    ASSERT_EQ(file.symbols[0].type, Symbol::Type::Function);
+    ASSERT_EQ(file.symbols[1].name, "buffer");
+    ASSERT_EQ(file.symbols[1].value, 0x10000000);
+    ASSERT_EQ(file.symbols[1].type, Symbol::Type::Object);
+}
+
+TEST(ElfTest, ReadFile)
+{
+    std::vector<uint8_t> bytes = MakeExecutable();
+    std::istringstream   iss { std::string(bytes.begin(), bytes.end()) };
+
+    FileReadResult result = ReadFile(iss);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+    ASSERT_EQ(std::get<CanRead>(result).entryPoint, 0x400004);
+    ASSERT_EQ(std::get<CanRead>(result).symbols.size(), 2);
+}
+
+TEST(ElfTest, Invalid)
+{
+    auto expectError = [](std::vector<uint8_t> const& bytes, FileReadError::Type type) {
+        FileReadResult result = ReadElfFile(bytes.data(), bytes.size());
+        ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+        ASSERT_EQ(std::get<CannotRead>(result).error.type, type);
+    };
+
+    // Little endian
+    std::vector<uint8_t> bytes = MakeExecutable();
+    bytes[5]                   = 1;
+    expectError(bytes, FileReadError::Type::InvalidFormat);
+
+    // Not MIPS
+    bytes = MakeExecutable();
+    PutHalf(bytes, 18, 3);
+    expectError(bytes, FileReadError::Type::InvalidFormat);
+
+    // Segment below the text segment
+    bytes = MakeExecutable();
+    PutWord(bytes, 52 + 8, 0x1000);
+    expectError(bytes, FileReadError::Type::InvalidFormat);
+
+    // Segment beyond the end of the file
+    bytes = MakeExecutable();
+    PutWord(bytes, 84 + 4, 310);
+    expectError(bytes, FileReadError::Type::SectionSizeDoesNotMatch);
+
+    // Entry point outside the text segment
+    bytes = MakeExecutable();
+    PutWord(bytes, 24, 0x10000000);
+    expectError(bytes, FileReadError::Type::InvalidFormat);
+
+    // Truncated
+    bytes = MakeExecutable();
+    bytes.resize(200);
+    expectError(bytes, FileReadError::Type::InvalidFormat);
+}
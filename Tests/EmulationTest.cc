@@ -2,20 +2,28 @@
 // Licensed under the MIT License.
 
 #include <gtest/gtest.h>
+#include <pip-mips-emu/Cache.hh>
+#include <pip-mips-emu/Dram.hh>
 #include <pip-mips-emu/Emulator.hh>
 #include <pip-mips-emu/File.hh>
 #include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Observer.hh>
+#include <pip-mips-emu/WriteBuffer.hh>
+
+#include "TestCommon.hh"
 
 std::pair<Emulator, Memory> MakeDefaultEmulator(std::vector<uint8_t>&& text,
                                                 std::vector<uint8_t>&& data,
-                                                bool                   atp = true)
+                                                bool                   atp              = true,
+                                                MemoryLevelPtr         instructionLevel = nullptr,
+                                                MemoryLevelPtr         dataLevel        = nullptr)
 {
     EmulatorBuilder builder;
 
-    builder.AddDatapath<InstructionFetch>()
+    builder.AddDatapath<InstructionFetch>(std::move(instructionLevel))
         .AddDatapath<InstructionDecode>()
         .AddDatapath<Execution>()
-        .AddDatapath<MemoryAccess>()
+        .AddDatapath<MemoryAccess>(std::move(dataLevel))
         .AddDatapath<WriteBack>()
         .AddHandler<DefaultHandler>();
 
@@ -27,72 +35,6 @@ std::pair<Emulator, Memory> MakeDefaultEmulator(std::vector<uint8_t>&& text,
     return builder.Build(std::move(text), std::move(data));
 }
 
-/*
-    .data
-array:
-    .word 0
-    .word 1
-    .word 0
-    .word 0
-    .word 0
-    .word 0
-    .word 0
-    .word 0
-    .word 0
-    .word 0
-array_end:
-
-    .text
-main:
-    la     $8,   array
-    la     $9,   array_end
-    addiu  $9,   $9,   -8
-loop:
-    lw     $10,  0($8)
-    lw     $11,  4($8)
-    addu   $10,  $10,  $11
-    sw     $10,  8($8)
-    addiu  $8,   4
-    bne    $8,   $9,   loop
-*/
-
-/*
-    uint32_t array[10] = { 0, 1 };
-    int main() {
-        uint32_t* r8 = array;
-        uint32_t* r9 = array_end - 2;
-        while (r8 != r9) {
-            r8[2] = r8[0] + r8[1];
-            r8 += 1;
-        }
-    }
-*/
-
-char const _fibonacci[] = R"===(
-    0x28
-    0x28
-    0x3c081000
-    0x3c091000
-    0x35290028
-    0x2529fff8
-    0x8d0a0000
-    0x8d0b0004
-    0x14b5021
-    0xad0a0008
-    0x25080004
-    0x1509fffa
-    0x0
-    0x1
-    0x0
-    0x0
-    0x0
-    0x0
-    0x0
-    0x0
-    0x0
-    0x0
-)===";
-
 TEST(ATPEmulationTest, Fibonacci)
 {
     std::istringstream iss { _fibonacci };
@@ -113,15 +55,11 @@ TEST(ATPEmulationTest, Fibonacci)
     ASSERT_EQ(j, 52);
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint32_t> expected { 0, 1, 1, 2, 3, 5, 8, 13, 21, 34 };
+        std::vector<uint32_t> actual(expected.size());
 
-        for (size_t i = 0; i < 10; ++i) {
-            ASSERT_EQ(memory.GetWord(address), expected[i]);
-            address.offset += 4;
-        }
-        // clang-format on
+        memory.ReadWords(Address::MakeData(0), actual.data(), actual.size());
+        ASSERT_EQ(actual, expected);
     }
 }
 
@@ -146,18 +84,98 @@ TEST(ANTPEmulationTest, Fibonacci)
     ASSERT_EQ(j, 52);
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint32_t> expected { 0, 1, 1, 2, 3, 5, 8, 13, 21, 34 };
+        std::vector<uint32_t> actual(expected.size());
 
-        for (size_t i = 0; i < 10; ++i) {
-            ASSERT_EQ(memory.GetWord(address), expected[i]);
-            address.offset += 4;
-        }
-        // clang-format on
+        memory.ReadWords(Address::MakeData(0), actual.data(), actual.size());
+        ASSERT_EQ(actual, expected);
     }
 }
 
+// Counts the events reported by the emulator
+class CountingObserver : public EmulatorObserver
+{
+  public:
+    uint32_t numCycles = 0, numControls = 0, numDeltas = 0, numCommitted = 0;
+    uint32_t numFetches = 0, numLoads = 0, numStores = 0;
+
+    std::vector<uint32_t> committedPCs;
+
+  public:
+    void OnControlsResolved(Memory const&, std::vector<uint16_t> const&)
+    {
+        ++numControls;
+    }
+
+    void OnDeltaApplied(Memory const&, Delta const&)
+    {
+        ++numDeltas;
+    }
+
+    void OnMemoryAccess(StageAccess const& access)
+    {
+        if (access.kind == AccessKind::Fetch)
+        {
+            EXPECT_EQ(access.address, access.pc);
+            ++numFetches;
+            return;
+        }
+
+        EXPECT_EQ(access.size, 4);
+        EXPECT_GE(access.address, static_cast<uint32_t>(Address::MakeData(0)));
+        if (access.kind == AccessKind::Load)
+            ++numLoads;
+        else
+            ++numStores;
+    }
+
+    void OnInstructionCommitted(Memory const&, uint32_t pc)
+    {
+        ++numCommitted;
+        committedPCs.push_back(pc);
+    }
+
+    void OnCycleEnd(Memory const&)
+    {
+        ++numCycles;
+    }
+};
+
+TEST(ATPEmulationTest, Observer)
+{
+    std::istringstream iss { _fibonacci };
+
+    CanRead file = std::get<CanRead>(ReadFile(iss));
+
+    auto [emulator, memory] = MakeDefaultEmulator(std::move(file.text), std::move(file.data), true);
+
+    CountingObserver                                     first, second;
+    CompositeObserver<CountingObserver, CountingObserver> observer { first, second };
+
+    uint32_t i = 0, j = 0;
+    while (!emulator.IsTerminated(memory))
+    {
+        ASSERT_EQ(emulator.TickTock(memory, j, observer), TickTockResult::Success);
+        ++i;
+    }
+    ASSERT_EQ(j, 52);
+
+    for (CountingObserver const* counter : { &first, &second })
+    {
+        ASSERT_EQ(counter->numCycles, i);
+        ASSERT_EQ(counter->numControls, i);
+        ASSERT_GT(counter->numDeltas, 0);
+        ASSERT_EQ(counter->numCommitted, j);
+
+        // Every committed instruction was fetched, and some were flushed after fetched
+        ASSERT_GE(counter->numFetches, j);
+
+        // 'lw' twice and 'sw' once in each of the 8 iterations
+        ASSERT_EQ(counter->numLoads, 16);
+        ASSERT_EQ(counter->numStores, 8);
+    }
+    ASSERT_EQ(first.committedPCs.front(), static_cast<uint32_t>(Address::MakeText(0)));
+}
 /*
     .data
     .word 0
@@ -485,15 +503,11 @@ TEST(ATPEmulationTest, SelectionSort)
     }
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint32_t> expected { 4, 20, 42, 43, 62, 68, 74, 86, 95, 100 };
+        std::vector<uint32_t> actual(expected.size());
 
-        for (size_t i = 0; i < 10; ++i) {
-            ASSERT_EQ(memory.GetWord(address), expected[i]);
-            address.offset += 4;
-        }
-        // clang-format on
+        memory.ReadWords(Address::MakeData(0), actual.data(), actual.size());
+        ASSERT_EQ(actual, expected);
     }
 }
 
@@ -517,15 +531,11 @@ TEST(ANTPEmulationTest, SelectionSort)
     }
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint32_t> expected { 4, 20, 42, 43, 62, 68, 74, 86, 95, 100 };
+        std::vector<uint32_t> actual(expected.size());
 
-        for (size_t i = 0; i < 10; ++i) {
-            ASSERT_EQ(memory.GetWord(address), expected[i]);
-            address.offset += 4;
-        }
-        // clang-format on
+        memory.ReadWords(Address::MakeData(0), actual.data(), actual.size());
+        ASSERT_EQ(actual, expected);
     }
 }
 
@@ -860,17 +870,12 @@ TEST(ATPEmulationTest, Strcat)
     ASSERT_EQ(j, 64);
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint8_t> expected {
             'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', '!', 0, 0, 0, 0
         };
 
-        for (size_t i = 0; i < 16; ++i) {
-            ASSERT_EQ(memory.GetByte(address), expected[i]);
-            address.offset += 1;
-        }
-        // clang-format on
+        MemoryView actual = memory.View(Address::MakeData(0), expected.size());
+        ASSERT_EQ_VECTOR(actual, expected, *lit, *rit);
     }
 }
 
@@ -895,16 +900,136 @@ TEST(ANTPEmulationTest, Strcat)
     ASSERT_EQ(j, 64);
 
     {
-        // clang-format off
-        Address address = Address::MakeData(0);
         std::vector<uint8_t> expected {
             'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', '!', 0, 0, 0, 0
         };
 
-        for (size_t i = 0; i < 16; ++i) {
-            ASSERT_EQ(memory.GetByte(address), expected[i]);
-            address.offset += 1;
+        MemoryView actual = memory.View(Address::MakeData(0), expected.size());
+        ASSERT_EQ_VECTOR(actual, expected, *lit, *rit);
+    }
+}
+
+void RunCachedSelectionSort(bool atp)
+{
+    uint32_t numCycles = 0, numInstructions = 0;
+    {
+        std::istringstream iss { _selectionSort };
+
+        CanRead file = std::get<CanRead>(ReadFile(iss));
+
+        auto [emulator, memory]
+            = MakeDefaultEmulator(std::move(file.text), std::move(file.data), atp);
+        while (!emulator.IsTerminated(memory))
+        {
+            ASSERT_EQ(emulator.TickTock(memory, numInstructions), TickTockResult::Success);
+            ++numCycles;
         }
-        // clang-format on
     }
+
+    std::istringstream iss { _selectionSort };
+
+    CanRead file = std::get<CanRead>(ReadFile(iss));
+
+    auto instructionCache = std::make_shared<Cache>(CacheConfig { 64, 1, 16 });
+    auto dataCache        = std::make_shared<Cache>(CacheConfig { 32, 2, 8 });
+
+    auto [emulator, memory] = MakeDefaultEmulator(
+        std::move(file.text), std::move(file.data), atp, instructionCache, dataCache);
+
+    uint32_t i = 0, j = 0;
+    while (!emulator.IsTerminated(memory))
+    {
+        ASSERT_EQ(emulator.TickTock(memory, j), TickTockResult::Success);
+        ++i;
+    }
+
+    // Misses only delay the pipeline
+    ASSERT_EQ(j, numInstructions);
+    ASSERT_GT(i, numCycles);
+
+    ASSERT_GT(instructionCache->GetStats().readHits, 0);
+    ASSERT_GT(instructionCache->GetStats().readMisses, 0);
+    ASSERT_EQ(instructionCache->GetStats().writeHits + instructionCache->GetStats().writeMisses,
+              0);
+    ASSERT_GT(dataCache->GetStats().writeHits + dataCache->GetStats().writeMisses, 0);
+    ASSERT_GT(dataCache->GetStats().writeBacks, 0);
+
+    {
+        std::vector<uint32_t> expected { 4, 20, 42, 43, 62, 68, 74, 86, 95, 100 };
+        std::vector<uint32_t> actual(expected.size());
+
+        memory.ReadWords(Address::MakeData(0), actual.data(), actual.size());
+        ASSERT_EQ(actual, expected);
+    }
+}
+
+TEST(ATPEmulationTest, CachedSelectionSort)
+{
+    RunCachedSelectionSort(true);
+}
+
+TEST(ANTPEmulationTest, CachedSelectionSort)
+{
+    RunCachedSelectionSort(false);
+}
+
+uint32_t CountCycles(char const* program, bool atp, MemoryLevelPtr dataLevel)
+{
+    std::istringstream iss { program };
+
+    CanRead file = std::get<CanRead>(ReadFile(iss));
+
+    auto [emulator, memory] = MakeDefaultEmulator(
+        std::move(file.text), std::move(file.data), atp, nullptr, std::move(dataLevel));
+
+    uint32_t i = 0, j = 0;
+    while (!emulator.IsTerminated(memory))
+    {
+        EXPECT_EQ(emulator.TickTock(memory, j), TickTockResult::Success);
+        ++i;
+    }
+
+    return i;
+}
+
+TEST(ATPEmulationTest, WriteBufferStrcat)
+{
+    auto dram        = std::make_shared<Dram>(DramConfig {});
+    auto writeBuffer = std::make_shared<WriteBuffer>(WriteBufferConfig { 4 }, dram);
+
+    uint32_t const numCyclesWithoutBuffer = CountCycles(_strcat, true, dram);
+    uint32_t const numCyclesWithBuffer    = CountCycles(_strcat, true, writeBuffer);
+    ASSERT_LT(numCyclesWithBuffer, numCyclesWithoutBuffer);
+
+    WriteBufferStats const& stats = writeBuffer->GetStats();
+    ASSERT_GT(stats.stores, 0);
+    ASSERT_EQ(stats.forwardedLoads, 0);
+}
+
+TEST(ATPEmulationTest, WriteBufferSimpleLoadUse)
+{
+    auto dram        = std::make_shared<Dram>(DramConfig {});
+    auto writeBuffer = std::make_shared<WriteBuffer>(WriteBufferConfig { 4 }, dram);
+
+    CountCycles(_simpleLoadUse, true, writeBuffer);
+
+    // 'lw $5, 4($1)' reads the word written by the preceding 'sb's
+    WriteBufferStats const& stats = writeBuffer->GetStats();
+    ASSERT_EQ(stats.stores, 4);
+    ASSERT_EQ(stats.loads, 4);
+    ASSERT_EQ(stats.forwardedLoads, 1);
+}
+
+TEST(ANTPEmulationTest, WriteBufferSelectionSort)
+{
+    auto dram        = std::make_shared<Dram>(DramConfig {});
+    auto writeBuffer = std::make_shared<WriteBuffer>(WriteBufferConfig { 1 }, dram);
+
+    uint32_t const numCyclesWithoutBuffer = CountCycles(_selectionSort, false, dram);
+    uint32_t const numCyclesWithBuffer    = CountCycles(_selectionSort, false, writeBuffer);
+    ASSERT_LT(numCyclesWithBuffer, numCyclesWithoutBuffer);
+
+    WriteBufferStats const& stats = writeBuffer->GetStats();
+    ASSERT_GT(stats.stores, 0);
+    ASSERT_EQ(stats.maxOccupancy, 1);
 }
@@ -5,6 +5,7 @@
 #include <pip-mips-emu/File.hh>
 
 #include "TestCommon.hh"
+#include <fstream>
 #include <sstream>
 
 char const _validCase[] = R"===(
@@ -86,4 +87,128 @@ TEST(FileTest, InvalidSectionSize)
 
     CannotRead error = std::get<CannotRead>(result);
     ASSERT_EQ(error.error.type, FileReadError::Type::SectionSizeDoesNotMatch);
-}
\ No newline at end of file
+}
+
+TEST(FileTest, Whitespace)
+{
+    {
+        // Blank lines may contain any whitespace, but only spaces may surround a word
+        std::istringstream iss { "0x4\n 0x0 \n\t \r\n0x0000000000000000012  \n" };
+
+        FileReadResult result = ReadFile(iss);
+        ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+        std::vector<uint8_t> expected { 0x00, 0x00, 0x00, 0x12 };
+        ASSERT_EQ(std::get<CanRead>(result).text, expected);
+    }
+
+    char const* inputs[] = {
+        "0x4\n0x0\n\t0x12\n",
+        "0x4\n0x0\n0x12\r\n",
+        "0x4\n0x0\n0X12\n",
+        "0x4\n0x0\n0x\n",
+        "0x4\n0x0\n0x123456789\n",
+    };
+    for (char const* input : inputs)
+    {
+        std::istringstream iss { input };
+
+        FileReadResult result = ReadFile(iss);
+        ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+        ASSERT_EQ(std::get<CannotRead>(result).error.type, FileReadError::Type::InvalidFormat);
+    }
+}
+
+TEST(FileTest, InvalidFormatAfterSectionSize)
+{
+    // The format is validated before the sizes of the sections
+    std::istringstream iss { "0x4\n0x0\n0x1\n0x2\nhello" };
+
+    FileReadResult result = ReadFile(iss);
+    ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+    ASSERT_EQ(std::get<CannotRead>(result).error.type, FileReadError::Type::InvalidFormat);
+}
+
+TEST(FileTest, LargeInput)
+{
+    constexpr uint32_t numWords = 100000;
+
+    // Lines of various lengths span the boundaries of the chunks
+    std::ostringstream oss;
+    oss << std::hex << "0x" << numWords * 2 << "\n0x" << numWords * 2 << '\n';
+    for (uint32_t i = 0; i < numWords; ++i)
+        oss << std::string(i % 7, ' ') << "0x" << i * 0x9E3779B1 << '\n';
+
+    std::istringstream iss { oss.str() };
+
+    FileReadResult result = ReadFile(iss);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+
+    CanRead const& file = std::get<CanRead>(result);
+    ASSERT_EQ(file.text.size(), numWords * 2);
+    ASSERT_EQ(file.data.size(), numWords * 2);
+
+    for (uint32_t i = 0; i < numWords; ++i)
+    {
+        std::vector<uint8_t> const& segment = i < numWords / 2 ? file.text : file.data;
+        uint8_t const*              ptr     = segment.data() + (i % (numWords / 2)) * 4;
+
+        uint32_t const expected = i * 0x9E3779B1;
+        ASSERT_EQ(ptr[0], static_cast<uint8_t>(expected >> 24));
+        ASSERT_EQ(ptr[3], static_cast<uint8_t>(expected));
+    }
+}
+
+TEST(FileTest, Binary)
+{
+    std::istringstream textIss { _validCase };
+    CanRead            expected = std::get<CanRead>(ReadFile(textIss));
+    expected.entryPoint         = 0x400004;
+
+    std::stringstream ss;
+    WriteBinaryFile(expected, ss);
+    ASSERT_EQ(ss.str().size(), BinaryFileHeaderSize + 8 + 16);
+
+    FileReadResult result = ReadFile(ss);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+
+    CanRead const& file = std::get<CanRead>(result);
+    ASSERT_EQ(file.text, expected.text);
+    ASSERT_EQ(file.data, expected.data);
+    ASSERT_EQ(file.entryPoint, expected.entryPoint);
+
+    // Truncated
+    std::string        bytes = ss.str();
+    std::istringstream truncated { bytes.substr(0, bytes.size() - 1) };
+    result = ReadFile(truncated);
+    ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+    ASSERT_EQ(std::get<CannotRead>(result).error.type,
+              FileReadError::Type::SectionSizeDoesNotMatch);
+
+    // Unknown version
+    bytes[7] = 2;
+    std::istringstream unknownVersion { bytes };
+    result = ReadFile(unknownVersion);
+    ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+    ASSERT_EQ(std::get<CannotRead>(result).error.type, FileReadError::Type::InvalidFormat);
+}
+
+TEST(FileTest, BinaryFromPath)
+{
+    std::istringstream textIss { _validCase };
+    CanRead            expected = std::get<CanRead>(ReadFile(textIss));
+
+    auto path = std::filesystem::temp_directory_path() / "pip-mips-emu-file-test.bin";
+    {
+        std::ofstream ofs { path, std::ios::binary };
+        WriteBinaryFile(expected, ofs);
+    }
+
+    FileReadResult result = ReadFile(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+
+    CanRead const& file = std::get<CanRead>(result);
+    ASSERT_EQ(file.text, expected.text);
+    ASSERT_EQ(file.data, expected.data);
+    ASSERT_EQ(file.entryPoint, Address::MakeText(0));
+}
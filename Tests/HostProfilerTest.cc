@@ -0,0 +1,59 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/HostProfiler.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include "TestCommon.hh"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(HostProfilerTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    HostProfiler profiler { emulator };
+
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, profiler), TickTockResult::Success);
+
+    // Each component is measured once a cycle
+    auto const controllers = profiler.GetEntries(HostPhase::Controller);
+    ASSERT_EQ(controllers.size(), 1);
+    EXPECT_EQ(controllers[0].name, "ATPPipelineStateController");
+    EXPECT_EQ(controllers[0].samples, 72);
+
+    auto const datapaths = profiler.GetEntries(HostPhase::Datapath);
+    ASSERT_EQ(datapaths.size(), 5);
+    for (auto const& entry : datapaths) EXPECT_EQ(entry.samples, 72) << entry.name;
+
+    std::vector<std::string> names;
+    for (auto const& entry : datapaths) names.push_back(entry.name);
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names,
+              (std::vector<std::string> { "Execution", "InstructionDecode", "InstructionFetch",
+                                          "MemoryAccess", "WriteBack" }));
+
+    for (auto const& entry : profiler.GetEntries(HostPhase::ApplyDeltas))
+        EXPECT_EQ(entry.samples, 72);
+
+    // GetPCs is called only for the observers of the commits
+    auto const handler = profiler.GetEntries(HostPhase::Handler);
+    EXPECT_EQ(handler[0].name, "DefaultHandler::IsTerminated");
+    EXPECT_EQ(handler[0].samples, 72);
+    EXPECT_EQ(handler[1].samples, 72);
+    EXPECT_EQ(handler[2].samples, 0);
+
+    std::ostringstream oss;
+    profiler.WriteReport(oss);
+    EXPECT_NE(oss.str().find("Host ticks of 72 cycles"), std::string::npos);
+    EXPECT_NE(oss.str().find("  InstructionFetch\n"), std::string::npos);
+    EXPECT_EQ(oss.str().find("GetPCs"), std::string::npos);
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/InstructionMix.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+
+TEST(InstructionMixTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    InstructionMix mix { emulator };
+
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, mix), TickTockResult::Success);
+
+    EXPECT_EQ(mix.GetInstructions(), numInstructions);
+
+    // lui and ori set the bounds, and the loop runs 8 times
+    EXPECT_EQ(mix.GetCount(IIFormatOp::LUI), 2);
+    EXPECT_EQ(mix.GetCount(IFormatOp::ORI), 1);
+    EXPECT_EQ(mix.GetCount(IFormatOp::ADDIU), 1 + 8);
+    EXPECT_EQ(mix.GetCount(OIFormatOp::LW), 16);
+    EXPECT_EQ(mix.GetCount(RFormatFn::ADDU), 8);
+    EXPECT_EQ(mix.GetCount(OIFormatOp::SW), 8);
+    EXPECT_EQ(mix.GetCount(BIFormatOp::BNE), 8);
+    EXPECT_EQ(mix.GetCount(BIFormatOp::BEQ), 0);
+    EXPECT_EQ(mix.GetCount(SRFormatFn::SLL), 0);
+
+    EXPECT_EQ(mix.GetCount(InstructionClass::Alu), 20);
+    EXPECT_EQ(mix.GetCount(InstructionClass::Load), 16);
+    EXPECT_EQ(mix.GetCount(InstructionClass::Store), 8);
+    EXPECT_EQ(mix.GetCount(InstructionClass::Branch), 8);
+
+    // The branch falls through only in the last iteration
+    EXPECT_EQ(mix.GetTakenBranches(BIFormatOp::BNE), 7);
+
+    std::ostringstream oss;
+    mix.WriteReport(oss);
+    EXPECT_NE(oss.str().find("\n        lw        16   30.77\n"), std::string::npos);
+    EXPECT_NE(oss.str().find("\n       bne         7         1   87.50\n"), std::string::npos);
+}
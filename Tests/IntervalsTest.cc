@@ -0,0 +1,134 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Intervals.hh>
+
+#include "TestCommon.hh"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+
+std::string ReadContents(std::filesystem::path const& path)
+{
+    std::ifstream ifs { path, std::ios::binary };
+    return std::string { std::istreambuf_iterator<char> { ifs }, {} };
+}
+
+class IntervalsTest : public testing::Test
+{
+  protected:
+    std::filesystem::path _binaryPath, _csvPath;
+
+  protected:
+    void SetUp() override
+    {
+        auto const directory = std::filesystem::temp_directory_path();
+        _binaryPath          = directory / "pip-mips-emu-intervals-test.pmi";
+        _csvPath             = directory / "pip-mips-emu-intervals-test.csv";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(_binaryPath);
+        std::filesystem::remove(_csvPath);
+    }
+
+    void Run(uint32_t interval)
+    {
+        auto [emulator, memory] = BuildFibonacci();
+
+        AsyncWriter binary { _binaryPath, AsyncWriterConfig { 64, OverflowPolicy::Block } };
+        AsyncWriter csv { _csvPath, AsyncWriterConfig { 64, OverflowPolicy::Block } };
+        {
+            IntervalWriter writer { emulator, interval, &binary, &csv };
+
+            uint32_t numInstructions = 0;
+            while (!emulator.IsTerminated(memory))
+            {
+                ASSERT_EQ(emulator.TickTock(memory, numInstructions, writer),
+                          TickTockResult::Success);
+            }
+            writer.Flush();
+        }
+        binary.Close();
+        csv.Close();
+    }
+};
+
+uint32_t Sum(std::vector<IntervalRow> const& rows, IntervalColumn column)
+{
+    uint32_t sum = 0;
+    for (auto const& row : rows) sum += row[static_cast<size_t>(column)];
+    return sum;
+}
+
+}
+
+TEST_F(IntervalsTest, Fibonacci)
+{
+    Run(10);
+
+    std::ifstream            ifs { _binaryPath, std::ios::binary };
+    uint32_t                 interval = 0;
+    std::vector<IntervalRow> rows     = DecodeIntervals(ifs, &interval);
+    EXPECT_EQ(interval, 10);
+
+    // The last interval has the remaining 2 of the 72 cycles
+    ASSERT_EQ(rows.size(), 8);
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        uint32_t const cycles = i + 1 < rows.size() ? 10 : 2;
+        EXPECT_EQ(rows[i][static_cast<size_t>(IntervalColumn::Cycle)], i * 10 + cycles);
+        EXPECT_EQ(rows[i][static_cast<size_t>(IntervalColumn::Cycles)], cycles);
+    }
+
+    EXPECT_EQ(Sum(rows, IntervalColumn::Instructions), 52);
+    EXPECT_EQ(Sum(rows, IntervalColumn::LoadUseStalls), 8);
+    EXPECT_EQ(Sum(rows, IntervalColumn::MemoryStalls), 0);
+    EXPECT_EQ(Sum(rows, IntervalColumn::Loads), 16);
+    EXPECT_EQ(Sum(rows, IntervalColumn::Stores), 8);
+
+    // The loop branch is taken except for the last iteration, which is mispredicted
+    EXPECT_EQ(Sum(rows, IntervalColumn::Branches), 8);
+    EXPECT_EQ(Sum(rows, IntervalColumn::TakenBranches), 7);
+    EXPECT_EQ(Sum(rows, IntervalColumn::Mispredictions), 1);
+
+    // The CSV has the same rows
+    std::ostringstream expected;
+    expected << "cycle,cycles,instructions,loadUseStalls,memoryStalls,flushCycles,branches,"
+                "takenBranches,mispredictions,loads,stores\n";
+    for (auto const& row : rows)
+    {
+        for (size_t i = 0; i < NumIntervalColumns; ++i) expected << (i ? "," : "") << row[i];
+        expected << '\n';
+    }
+    EXPECT_EQ(ReadContents(_csvPath), expected.str());
+}
+
+TEST_F(IntervalsTest, EveryCycle)
+{
+    Run(1);
+
+    std::ifstream            ifs { _binaryPath, std::ios::binary };
+    std::vector<IntervalRow> rows = DecodeIntervals(ifs);
+    ASSERT_EQ(rows.size(), 72);
+    EXPECT_EQ(Sum(rows, IntervalColumn::Cycles), 72);
+    EXPECT_EQ(Sum(rows, IntervalColumn::Instructions), 52);
+
+    // Truncated files are rejected
+    std::string const  contents = ReadContents(_binaryPath);
+    std::istringstream truncated { contents.substr(0, IntervalFileHeaderSize + 8) };
+    EXPECT_THROW(DecodeIntervals(truncated), std::runtime_error);
+
+    std::istringstream invalid { "not interval statistics" };
+    EXPECT_THROW(DecodeIntervals(invalid), std::runtime_error);
+}
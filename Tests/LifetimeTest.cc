@@ -0,0 +1,63 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Lifetime.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+
+TEST(LifetimeTest, Classify)
+{
+    EXPECT_EQ(Classify(0x3c081000), InstructionClass::Alu);
+    EXPECT_EQ(Classify(0x00084080), InstructionClass::Alu);
+    EXPECT_EQ(Classify(0x8d0b0004), InstructionClass::Load);
+    EXPECT_EQ(Classify(0xad0a0008), InstructionClass::Store);
+    EXPECT_EQ(Classify(0x1509fffa), InstructionClass::Branch);
+    EXPECT_EQ(Classify(0x0c100004), InstructionClass::Jump);
+    EXPECT_EQ(Classify(0x03e00008), InstructionClass::Jump);
+    EXPECT_EQ(Classify(0x00000000), InstructionClass::Nop);
+    EXPECT_EQ(Classify(0xfc000000), InstructionClass::Unknown);
+}
+
+TEST(LifetimeTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    LifetimeTracker tracker { emulator };
+
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, tracker), TickTockResult::Success);
+
+    // Each addu waits a cycle in IF/ID for the load before it
+    LifetimeStats const& alu = tracker.GetStats(InstructionClass::Alu);
+    EXPECT_EQ(alu.count, 20);
+    EXPECT_EQ(alu.latencySum, 20 * 5 + 8);
+    EXPECT_EQ(alu.maxLatency, 6);
+    EXPECT_EQ(alu.latchCycles[0], 20 + 8);
+    EXPECT_EQ(alu.histogram[5], 12);
+    EXPECT_EQ(alu.histogram[6], 8);
+
+    LifetimeStats const& load = tracker.GetStats(InstructionClass::Load);
+    EXPECT_EQ(load.count, 16);
+    EXPECT_EQ(load.histogram[5], 16);
+
+    EXPECT_EQ(tracker.GetStats(InstructionClass::Store).count, 8);
+    EXPECT_EQ(tracker.GetStats(InstructionClass::Branch).count, 8);
+    EXPECT_EQ(tracker.GetStats(InstructionClass::Nop).count, 0);
+
+    LifetimeStats const total = tracker.GetTotalStats();
+    EXPECT_EQ(total.count, numInstructions);
+    EXPECT_EQ(total.latencySum, 52 * 5 + 8);
+
+    std::ostringstream oss;
+    tracker.WriteReport(oss);
+    EXPECT_NE(oss.str().find("         6         8         8         0         0         0\n"),
+              std::string::npos);
+}
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <gtest/gtest.h>
+#include <pip-mips-emu/Common.hh>
 #include <pip-mips-emu/Memory.hh>
 
 TEST(MemoryTest, Init)
@@ -17,10 +18,12 @@ TEST(MemoryTest, Init)
     ASSERT_EQ(memory.GetRegister(32), Address::MakeText(0));
 
     ASSERT_EQ(memory.GetTextSize(), 7);
-    for (uint32_t i = 0; i < 7; ++i) ASSERT_EQ(memory.GetByte(Address::MakeText(i)), 0);
+    ASSERT_EQ(memory.View(Address::BaseType::Text).size(), 7);
+    for (uint8_t byte : memory.View(Address::BaseType::Text)) ASSERT_EQ(byte, 0);
 
     ASSERT_EQ(memory.GetDataSize(), 9);
-    for (uint32_t i = 0; i < 9; ++i) ASSERT_EQ(memory.GetByte(Address::MakeData(i)), 0);
+    ASSERT_EQ(memory.View(Address::BaseType::Data).size(), 9);
+    for (uint8_t byte : memory.View(Address::BaseType::Data)) ASSERT_EQ(byte, 0);
 }
 
 TEST(MemoryTest, Load)
@@ -37,6 +40,33 @@ TEST(MemoryTest, Load)
     ASSERT_EQ(memory.GetWord(Address::MakeData(2)), 0x08070605);
 }
 
+TEST(MemoryTest, Bulk)
+{
+    Memory memory { 0, 8, 10 };
+
+    std::vector<uint8_t> bytes { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC };
+    memory.WriteBytes(Address::MakeData(3), bytes.data(), bytes.size());
+    EXPECT_THROW(memory.WriteBytes(Address::MakeData(5), bytes.data(), bytes.size()),
+                 std::out_of_range);
+    EXPECT_THROW(memory.WriteBytes(Address::MakeText(9), bytes.data(), 0), std::out_of_range);
+
+    std::vector<uint8_t> actualBytes(12, 0xFF);
+    memory.ReadBytes(Address::MakeData(2), actualBytes.data(), actualBytes.size());
+    ASSERT_EQ(actualBytes,
+              (std::vector<uint8_t> { 0, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0, 0, 0, 0, 0 }));
+
+    std::vector<uint32_t> actualWords(4, 0xFFFFFFFF);
+    memory.ReadWords(Address::MakeData(1), actualWords.data(), actualWords.size());
+    ASSERT_EQ(actualWords, (std::vector<uint32_t> { 0x00001234, 0x56789ABC, 0x00000000, 0 }));
+
+    MemoryView view = memory.View(Address::MakeData(4), 4);
+    ASSERT_EQ(view.size(), 4);
+    ASSERT_EQ(view[0], 0x34);
+    ASSERT_EQ(view[3], 0x9A);
+    EXPECT_THROW(memory.View(Address::MakeData(4), 7), std::out_of_range);
+    ASSERT_TRUE(memory.View(Address::MakeData(10), 0).empty());
+}
+
 TEST(MemoryTest, Register)
 {
     Memory memory { 17, 0, 0 };
@@ -80,4 +110,51 @@ TEST(MemoryTest, InvalidAddressParse)
 
     Address addr;
     for (auto& input : inputs) ASSERT_FALSE(Address::Parse(input, input + strlen(input), addr));
-}
\ No newline at end of file
+}
+
+TEST(MemoryTest, Diff)
+{
+    Memory lhs { 2, 64, 100 };
+    Memory rhs { lhs };
+
+    ASSERT_TRUE(Memory::Diff(lhs, rhs).IsEmpty());
+    ASSERT_EQ(lhs.Hash(), rhs.Hash());
+
+    rhs.SetRegister(3, 0x1234);
+    rhs.SetRegister(34, 0x5678);
+    rhs.SetWord(Address::MakeText(16), 0x00FFFF00);
+    rhs.SetByte(Address::MakeText(40), 0x01);
+    rhs.SetByte(Address::MakeData(99), 0x01);
+    ASSERT_NE(lhs.Hash(), rhs.Hash());
+
+    MemoryDiff diff = Memory::Diff(lhs, rhs);
+    ASSERT_EQ(diff.registers, (std::vector<uint32_t> { 3, 34 }));
+    ASSERT_EQ(diff.ranges.size(), 3);
+    ASSERT_EQ(diff.ranges[0].begin, Address::MakeText(17));
+    ASSERT_EQ(diff.ranges[0].end, Address::MakeText(18));
+    ASSERT_EQ(diff.ranges[1].begin, Address::MakeText(40));
+    ASSERT_EQ(diff.ranges[1].end, Address::MakeText(40));
+    ASSERT_EQ(diff.ranges[2].begin, Address::MakeData(99));
+    ASSERT_EQ(diff.ranges[2].end, Address::MakeData(99));
+
+    // Bytes and registers which exist in only one of the objects
+    Memory larger { 3, 64, 104 };
+    diff = Memory::Diff(lhs, larger);
+    ASSERT_EQ(diff.registers, (std::vector<uint32_t> { 35 }));
+    ASSERT_EQ(diff.ranges.size(), 1);
+    ASSERT_EQ(diff.ranges[0].begin, Address::MakeData(100));
+    ASSERT_EQ(diff.ranges[0].end, Address::MakeData(103));
+}
+
+TEST(MemoryTest, Hash)
+{
+    char const input[] = "abc";
+    ASSERT_EQ(Hash64(input, 0), 0xEF46DB3751D8E999);
+    ASSERT_EQ(Hash64(input, 1), 0xD24EC4F1A98C6E5B);
+    ASSERT_EQ(Hash64(input, 3), 0x44BC2CF5AD770999);
+
+    std::vector<uint8_t> bytes(1000);
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 7);
+    ASSERT_NE(Hash64(bytes.data(), bytes.size()), Hash64(bytes.data(), bytes.size(), 1));
+    ASSERT_NE(Hash64(bytes.data(), bytes.size()), Hash64(bytes.data(), bytes.size() - 1));
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/PerfCounters.hh>
+
+#include <sstream>
+
+TEST(PerfCountersTest, Read)
+{
+    // The counters may not be available on the host, in which case they must be skipped
+    PerfCounters counters;
+    counters.Start();
+
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 100000; ++i) sum = sum + i;
+
+    counters.Stop();
+
+    for (size_t i = 0; i < NumPerfEvents; ++i)
+    {
+        auto const event = static_cast<PerfEvent>(i);
+        EXPECT_EQ(counters.Read(event).has_value(), counters.IsAvailable(event));
+    }
+
+    if (auto const instructions = counters.Read(PerfEvent::Instructions))
+    {
+        EXPECT_GE(instructions.value(), 100000);
+    }
+
+    std::ostringstream oss;
+    WritePerfReport(counters, 100, 80, oss);
+    if (counters.IsAnyAvailable())
+        EXPECT_NE(oss.str().find("Host counters of 100 emulated cycles"), std::string::npos);
+    else
+        EXPECT_EQ(oss.str(), "Host counters are not available\n");
+}
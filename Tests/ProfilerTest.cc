@@ -0,0 +1,73 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Disassembler.hh>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Profiler.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+
+TEST(ProfilerTest, Disassemble)
+{
+    EXPECT_EQ(Disassemble(0x3c081000, 0x400000), "lui $t0, 0x1000");
+    EXPECT_EQ(Disassemble(0x35290028, 0x400008), "ori $t1, $t1, 0x28");
+    EXPECT_EQ(Disassemble(0x2529fff8, 0x40000C), "addiu $t1, $t1, -8");
+    EXPECT_EQ(Disassemble(0x8d0b0004, 0x400014), "lw $t3, 4($t0)");
+    EXPECT_EQ(Disassemble(0x014b5021, 0x400018), "addu $t2, $t2, $t3");
+    EXPECT_EQ(Disassemble(0xad0a0008, 0x40001C), "sw $t2, 8($t0)");
+    EXPECT_EQ(Disassemble(0x1509fffa, 0x400024), "bne $t0, $t1, 0x400010");
+    EXPECT_EQ(Disassemble(0x0c100004, 0x400000), "jal 0x400010");
+    EXPECT_EQ(Disassemble(0x03e00008, 0x400000), "jr $ra");
+    EXPECT_EQ(Disassemble(0x00084080, 0x400000), "sll $t0, $t0, 2");
+    EXPECT_EQ(Disassemble(0x00000000, 0x400000), "nop");
+    EXPECT_EQ(Disassemble(0xfc000000, 0x400000), ".word 0xfc000000");
+}
+
+TEST(ProfilerTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    Profiler profiler { emulator, memory };
+    uint32_t numInstructions = 0;
+    while (!emulator.IsTerminated(memory))
+        ASSERT_EQ(emulator.TickTock(memory, numInstructions, profiler), TickTockResult::Success);
+
+    auto const& entries = profiler.GetEntries();
+    ASSERT_EQ(entries.size(), 10);
+
+    // Each cycle is attributed to an instruction or counted as not attributed
+    uint64_t sum = profiler.GetUnattributedCycles();
+    for (auto const& entry : entries) sum += entry.GetCycles();
+    ASSERT_EQ(sum, profiler.GetCycles());
+    ASSERT_EQ(profiler.GetCycles(), 72);
+
+    // The loop body from 'lw' to 'bne' runs 8 times
+    ASSERT_EQ(entries[0].commits, 1);
+    for (uint32_t i = 4; i < 10; ++i) ASSERT_EQ(entries[i].commits, 8);
+
+    // 'addu' waits for 'lw', and 'bne' flushes the instruction after it
+    ASSERT_EQ(entries[6].stallCycles, 8);
+    ASSERT_EQ(entries[9].flushCycles, 8);
+
+    std::ostringstream oss;
+    profiler.WriteFlatProfile(memory, oss);
+
+    std::string const profile = oss.str();
+    EXPECT_EQ(profile.find("Flat profile (72 cycles, 4 not attributed):\n"), 0);
+
+    // The hottest instructions come first
+    auto const addu = profile.find("addu $t2, $t2, $t3");
+    auto const lui  = profile.find("lui $t0, 0x1000");
+    EXPECT_NE(addu, std::string::npos);
+    EXPECT_LT(addu, lui);
+
+    oss.str("");
+    profiler.WriteAnnotatedListing(memory, oss);
+    EXPECT_NE(oss.str().find("         1    1.39         1         0         0  0x00400000  lui"),
+              std::string::npos);
+}
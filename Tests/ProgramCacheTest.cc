@@ -0,0 +1,124 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/ProgramCache.hh>
+
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+class ProgramCacheTest : public testing::Test
+{
+  protected:
+    fs::path _directory;
+
+  protected:
+    virtual void SetUp() override
+    {
+        _directory = fs::temp_directory_path() / "pip-mips-emu-program-cache-test";
+        fs::remove_all(_directory);
+        fs::create_directories(_directory / "images");
+    }
+
+    virtual void TearDown() override
+    {
+        fs::remove_all(_directory);
+    }
+
+    fs::path WriteProgram(char const* name, uint32_t value)
+    {
+        fs::path      path = _directory / name;
+        std::ofstream ofs { path };
+        ofs << "0x4\n0x4\n0x" << std::hex << value << "\n0x" << value + 1 << '\n';
+        return path;
+    }
+
+    size_t CountImages()
+    {
+        size_t rtn = 0;
+        for (auto& entry : fs::directory_iterator { _directory / "images" })
+        {
+            if (entry.path().extension() == ".pmeb")
+                ++rtn;
+        }
+        return rtn;
+    }
+};
+
+}
+
+TEST_F(ProgramCacheTest, HitAndMiss)
+{
+    fs::path     path = WriteProgram("program.txt", 0x1234);
+    ProgramCache cache { ProgramCacheConfig { _directory / "images" } };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        FileReadResult result = cache.Read(path);
+        ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+
+        CanRead const& file = std::get<CanRead>(result);
+        ASSERT_EQ(file.text, (std::vector<uint8_t> { 0x00, 0x00, 0x12, 0x34 }));
+        ASSERT_EQ(file.data, (std::vector<uint8_t> { 0x00, 0x00, 0x12, 0x35 }));
+    }
+
+    ASSERT_EQ(cache.GetStats().misses, 1);
+    ASSERT_EQ(cache.GetStats().hits, 1);
+    ASSERT_EQ(CountImages(), 1);
+
+    // The key is the contents, not the path
+    WriteProgram("program.txt", 0x5678);
+    FileReadResult result = cache.Read(path);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+    ASSERT_EQ(std::get<CanRead>(result).text, (std::vector<uint8_t> { 0x00, 0x00, 0x56, 0x78 }));
+    ASSERT_EQ(cache.GetStats().misses, 2);
+    ASSERT_EQ(CountImages(), 2);
+
+    // Errors are not cached
+    result = cache.Read(_directory / "nonexistent.txt");
+    ASSERT_TRUE(std::holds_alternative<CannotRead>(result));
+    ASSERT_EQ(std::get<CannotRead>(result).error.type, FileReadError::Type::FileDoesNotExist);
+    ASSERT_EQ(CountImages(), 2);
+}
+
+TEST_F(ProgramCacheTest, CorruptedImage)
+{
+    fs::path path = WriteProgram("program.txt", 0x1234);
+    ProgramCache { ProgramCacheConfig { _directory / "images" } }.Read(path);
+
+    for (auto& entry : fs::directory_iterator { _directory / "images" })
+        fs::resize_file(entry.path(), 10);
+
+    ProgramCache   cache { ProgramCacheConfig { _directory / "images" } };
+    FileReadResult result = cache.Read(path);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(result));
+    ASSERT_EQ(std::get<CanRead>(result).text, (std::vector<uint8_t> { 0x00, 0x00, 0x12, 0x34 }));
+    ASSERT_EQ(cache.GetStats().misses, 1);
+    ASSERT_EQ(cache.GetStats().stores, 1);
+}
+
+TEST_F(ProgramCacheTest, SizeLimit)
+{
+    // Each image has 28 bytes
+    ProgramCache cache { ProgramCacheConfig { _directory / "images", 60 } };
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        fs::path path = WriteProgram(("program" + std::to_string(i) + ".txt").c_str(), i);
+        ASSERT_TRUE(std::holds_alternative<CanRead>(cache.Read(path)));
+    }
+
+    ASSERT_EQ(cache.GetStats().stores, 4);
+    ASSERT_EQ(cache.GetStats().evictions, 2);
+    ASSERT_EQ(CountImages(), 2);
+
+    // Images larger than the limit are not stored
+    ProgramCache tinyCache { ProgramCacheConfig { _directory / "images", 20 } };
+    fs::path     path = WriteProgram("program.txt", 0x1234);
+    ASSERT_TRUE(std::holds_alternative<CanRead>(tinyCache.Read(path)));
+    ASSERT_EQ(tinyCache.GetStats().stores, 0);
+}
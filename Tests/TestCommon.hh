@@ -1,6 +1,17 @@
 // Copyright (c) 2021 Chanjung Kim. All rights reserved.
 // Licensed under the MIT License.
 
+#ifndef PIP_MIPS_EMU_TEST_COMMON_HH
+#define PIP_MIPS_EMU_TEST_COMMON_HH
+
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+
+#include <sstream>
+#include <utility>
+#include <variant>
+
 #define ASSERT_EQ_VECTOR(l, r, litExpr, ritExpr)                                                   \
     {                                                                                              \
         ASSERT_EQ((l).size(), (r).size());                                                         \
@@ -8,3 +19,95 @@
         auto rit = (r).begin(), rend = (r).end();                                                  \
         for (; lit != lend && rit != rend; ++lit, ++rit) ASSERT_EQ((litExpr), (ritExpr));          \
     }
+
+/*
+    .data
+array:
+    .word 0
+    .word 1
+    .word 0
+    .word 0
+    .word 0
+    .word 0
+    .word 0
+    .word 0
+    .word 0
+    .word 0
+array_end:
+
+    .text
+main:
+    la     $8,   array
+    la     $9,   array_end
+    addiu  $9,   $9,   -8
+loop:
+    lw     $10,  0($8)
+    lw     $11,  4($8)
+    addu   $10,  $10,  $11
+    sw     $10,  8($8)
+    addiu  $8,   4
+    bne    $8,   $9,   loop
+*/
+
+/*
+    uint32_t array[10] = { 0, 1 };
+    int main() {
+        uint32_t* r8 = array;
+        uint32_t* r9 = array_end - 2;
+        while (r8 != r9) {
+            r8[2] = r8[0] + r8[1];
+            r8 += 1;
+        }
+    }
+*/
+
+constexpr char _fibonacci[] = R"===(
+    0x28
+    0x28
+    0x3c081000
+    0x3c091000
+    0x35290028
+    0x2529fff8
+    0x8d0a0000
+    0x8d0b0004
+    0x14b5021
+    0xad0a0008
+    0x25080004
+    0x1509fffa
+    0x0
+    0x1
+    0x0
+    0x0
+    0x0
+    0x0
+    0x0
+    0x0
+    0x0
+    0x0
+)===";
+
+// Builds the default pipeline with the Fibonacci program loaded
+inline std::pair<Emulator, Memory> BuildFibonacci(MemoryLevelPtr instructionLevel = nullptr,
+                                                  MemoryLevelPtr dataLevel        = nullptr,
+                                                  bool           atp              = true)
+{
+    std::istringstream iss { _fibonacci };
+    CanRead            file = std::get<CanRead>(ReadFile(iss));
+
+    EmulatorBuilder builder;
+    builder.AddDatapath<InstructionFetch>(std::move(instructionLevel))
+        .AddDatapath<InstructionDecode>()
+        .AddDatapath<Execution>()
+        .AddDatapath<MemoryAccess>(std::move(dataLevel))
+        .AddDatapath<WriteBack>()
+        .AddHandler<DefaultHandler>();
+
+    if (atp)
+        builder.AddController<ATPPipelineStateController>();
+    else
+        builder.AddController<ANTPPipelineStateController>();
+
+    return builder.Build(std::move(file.text), std::move(file.data));
+}
+
+#endif
@@ -0,0 +1,226 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Trace.hh>
+
+#include "TestCommon.hh"
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <sstream>
+
+namespace
+{
+
+// Runs the program and returns the text printed for each cycle along with the trace. If a writer
+// is given, the trace is queued to it instead, one cycle at a time.
+std::pair<std::string, std::string> RunFibonacci(TraceConfig const& config,
+                                                 AsyncWriter* asyncWriter = nullptr)
+{
+    auto [emulator, memory] = BuildFibonacci();
+    auto& handler           = emulator.GetHandler();
+
+    std::ostringstream         text, trace;
+    std::optional<TraceWriter> writer;
+    if (asyncWriter)
+        writer.emplace(*asyncWriter, config);
+    else
+        writer.emplace(trace, config);
+
+    uint32_t numInstructions = 0;
+    for (uint32_t i = 1; !emulator.IsTerminated(memory); ++i)
+    {
+        EXPECT_EQ(emulator.TickTock(memory, numInstructions), TickTockResult::Success);
+        writer->WriteCycle(i, memory, *handler);
+        if (asyncWriter)
+            writer->Flush();
+
+        text << "===== Cycle " << i << " =====\n";
+        if (config.dumpPCs)
+        {
+            handler->DumpPCs(memory, text);
+            text << '\n';
+        }
+
+        if (config.dumpRegisters)
+        {
+            handler->DumpRegisters(memory, text);
+            text << '\n';
+            if (config.range)
+            {
+                handler->DumpMemory(memory, config.range.value(), text);
+                text << '\n';
+            }
+        }
+    }
+    writer->Flush();
+
+    return std::make_pair(text.str(), trace.str());
+}
+
+std::string Decode(std::string const& trace, TraceDecodeMode mode = TraceDecodeMode::Snapshots)
+{
+    std::istringstream iss { trace };
+    std::ostringstream oss;
+    DecodeTrace(iss, oss, mode);
+    return oss.str();
+}
+
+std::string ReadContents(std::filesystem::path const& path)
+{
+    std::ifstream ifs { path, std::ios::binary };
+    return std::string { std::istreambuf_iterator<char> { ifs }, {} };
+}
+
+// Splits the text printed by runfile into cycles
+std::map<uint32_t, std::string> SplitCycles(std::string const& text)
+{
+    std::map<uint32_t, std::string> rtn;
+
+    constexpr char Prefix[] = "===== Cycle ";
+    for (size_t begin = text.find(Prefix); begin != std::string::npos;)
+    {
+        size_t const end = text.find(Prefix, begin + 1);
+        rtn.emplace(std::stoul(text.substr(begin + sizeof(Prefix) - 1)),
+                    text.substr(begin, end - begin));
+        begin = end;
+    }
+    return rtn;
+}
+
+}
+
+TEST(TraceTest, Decode)
+{
+    TraceConfig configs[4];
+    configs[1].dumpPCs       = true;
+    configs[2].dumpRegisters = true;
+    configs[3].dumpPCs       = true;
+    configs[3].dumpRegisters = true;
+    configs[3].range         = Range { Address::MakeData(0), Address::MakeData(0x30) };
+
+    for (TraceConfig const& config : configs)
+    {
+        auto [text, trace] = RunFibonacci(config);
+        ASSERT_EQ(Decode(trace), text);
+    }
+}
+
+TEST(TraceTest, Size)
+{
+    TraceConfig config;
+    config.dumpRegisters = true;
+
+    auto [text, trace] = RunFibonacci(config);
+
+    // Only changed registers are recorded
+    ASSERT_EQ((trace.size() - TraceFileHeaderSize) % TraceRecordSize, 0);
+    ASSERT_LT(trace.size() * 10, text.size());
+}
+
+TEST(TraceTest, AppliedWrites)
+{
+    TraceConfig config;
+    config.dumpPCs       = true;
+    config.dumpRegisters = true;
+
+    // The range is not aligned, so each store changes two words in the range
+    Range const ranges[] {
+        Range { Address::MakeData(0), Address::MakeData(0x30) },
+        Range { Address::MakeData(2), Address::MakeData(0x2E) },
+    };
+    for (Range const& range : ranges)
+    {
+        config.range = range;
+
+        auto [emulator, memory] = BuildFibonacci();
+        auto& handler           = emulator.GetHandler();
+
+        WriteRecorder recorder;
+
+        std::ostringstream expected, actual;
+        TraceWriter        fullWriter { expected, config };
+        TraceWriter        writer { actual, config };
+
+        uint32_t numInstructions = 0;
+        for (uint32_t i = 1; !emulator.IsTerminated(memory); ++i)
+        {
+            ASSERT_EQ(emulator.TickTock(memory, numInstructions, recorder),
+                      TickTockResult::Success);
+            fullWriter.WriteCycle(i, memory, *handler);
+            writer.WriteCycle(i, memory, *handler, recorder.GetWrites());
+        }
+        fullWriter.Flush();
+        writer.Flush();
+
+        ASSERT_EQ(actual.str(), expected.str());
+    }
+}
+
+TEST(TraceTest, Changes)
+{
+    TraceConfig config;
+    config.dumpRegisters = true;
+    config.range         = Range { Address::MakeData(0), Address::MakeData(0x30) };
+
+    auto [text, trace]          = RunFibonacci(config);
+    std::string const changes   = Decode(trace, TraceDecodeMode::Changes);
+    std::string const snapshots = Decode(trace);
+    ASSERT_EQ(snapshots, text);
+
+    ASSERT_EQ(changes.find("===== Cycle 1 =====\nChanged registers:\nPC: 0x400004\n\n"), 0);
+    ASSERT_NE(changes.find("Changed memory:\n0x10000008: 0x1\n"), std::string::npos);
+    ASSERT_LT(changes.size() * 10, snapshots.size());
+}
+
+TEST(TraceTest, Invalid)
+{
+    auto [text, trace] = RunFibonacci(TraceConfig {});
+
+    EXPECT_THROW(Decode(trace.substr(0, trace.size() - 1)), std::runtime_error);
+    EXPECT_THROW(Decode("Hello, world!"), std::runtime_error);
+
+    // A record before the first cycle
+    std::string invalid = trace.substr(0, TraceFileHeaderSize);
+    invalid += std::string("\x03\0\0\0\x01\0\0\0\0\0\0\0", TraceRecordSize);
+    EXPECT_THROW(Decode(invalid), std::runtime_error);
+}
+
+TEST(TraceTest, Async)
+{
+    std::filesystem::path const path =
+        std::filesystem::temp_directory_path() / "pip-mips-emu-trace-test.pmt";
+
+    TraceConfig config;
+    config.dumpPCs       = true;
+    config.dumpRegisters = true;
+    config.range         = Range { Address::MakeData(0), Address::MakeData(0x30) };
+
+    {
+        AsyncWriter writer { path, AsyncWriterConfig { 64, OverflowPolicy::Block } };
+        auto [text, trace] = RunFibonacci(config, &writer);
+        writer.Close();
+        ASSERT_EQ(Decode(ReadContents(path)), text);
+    }
+
+    {
+        // Dropped cycles are missing, while the others must be decoded correctly
+        AsyncWriter writer { path, AsyncWriterConfig { 1024, OverflowPolicy::Drop } };
+        auto [text, trace] = RunFibonacci(config, &writer);
+        writer.Close();
+
+        auto const expected = SplitCycles(text);
+        auto const decoded  = SplitCycles(Decode(ReadContents(path)));
+        for (auto& [cycle, cycleText] : decoded) ASSERT_EQ(cycleText, expected.at(cycle));
+
+        ASSERT_EQ(decoded.size() == expected.size(), writer.GetStats().droppedBytes == 0);
+    }
+
+    std::filesystem::remove(path);
+}
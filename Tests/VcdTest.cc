@@ -0,0 +1,70 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Emulator.hh>
+#include <pip-mips-emu/File.hh>
+#include <pip-mips-emu/Implementations.hh>
+#include <pip-mips-emu/Vcd.hh>
+
+#include "TestCommon.hh"
+
+#include <sstream>
+
+TEST(VcdTest, Matches)
+{
+    EXPECT_TRUE(VcdWriter::Matches("IF_ID_*", "IF_ID_PC"));
+    EXPECT_TRUE(VcdWriter::Matches("*_PC", "MEM_WB_PC"));
+    EXPECT_TRUE(VcdWriter::Matches("*", ""));
+    EXPECT_TRUE(VcdWriter::Matches("?X_*", "EX_MEM_Instr"));
+    EXPECT_TRUE(VcdWriter::Matches("*M*M*", "EX_MEM_MemRead"));
+    EXPECT_FALSE(VcdWriter::Matches("IF_ID_*", "ID_EX_PC"));
+    EXPECT_FALSE(VcdWriter::Matches("*_PC", "IF_ID_PCX"));
+    EXPECT_FALSE(VcdWriter::Matches("pipelineState", "pipeline"));
+}
+
+TEST(VcdTest, NoMatch)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    std::ostringstream oss;
+    EXPECT_THROW(VcdWriter(oss, emulator, VcdConfig { { "NoSuchRegister" } }),
+                 std::invalid_argument);
+}
+
+TEST(VcdTest, Fibonacci)
+{
+    auto [emulator, memory] = BuildFibonacci();
+
+    std::ostringstream oss;
+    {
+        VcdWriter writer { oss, emulator, VcdConfig { { "IF_ID_PC", "pipelineState" } } };
+
+        uint32_t numInstructions = 0;
+        while (!emulator.IsTerminated(memory))
+            ASSERT_EQ(emulator.TickTock(memory, numInstructions, writer), TickTockResult::Success);
+    }
+
+    std::string const vcd = oss.str();
+
+    // Registers are declared before signals, and the identifiers are assigned in that order
+    EXPECT_NE(vcd.find("$var reg 32 ! IF_ID_PC $end\n$var wire 16 \" pipelineState $end\n"),
+              std::string::npos);
+    EXPECT_EQ(vcd.find("ID_EX_PC"), std::string::npos);
+
+    // The first cycle dumps all values, and IF_ID_PC holds the address of the first instruction
+    EXPECT_NE(vcd.find("#1\n$dumpvars\nb10000000000000000000000 !\n"), std::string::npos);
+
+    // Each time unit has at least one change
+    std::istringstream iss { vcd.substr(vcd.find("$end\n#2") + 5) };
+    std::string        line, previous;
+    while (std::getline(iss, line))
+    {
+        if (!previous.empty())
+        {
+            EXPECT_FALSE(previous[0] == '#' && line[0] == '#') << previous;
+        }
+        previous = line;
+    }
+    EXPECT_NE(previous[0], '#');
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 Chanjung Kim. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <pip-mips-emu/Dram.hh>
+#include <pip-mips-emu/WriteBuffer.hh>
+
+TEST(WriteBufferTest, InvalidConfig)
+{
+    EXPECT_THROW(WriteBuffer(WriteBufferConfig { 0, 1 }), std::invalid_argument);
+}
+
+TEST(WriteBufferTest, Drain)
+{
+    WriteBuffer buffer { WriteBufferConfig { 2, 3 } };
+
+    ASSERT_EQ(buffer.Access(0x10000000, AccessType::Write), 0);
+    ASSERT_EQ(buffer.Access(0x10000004, AccessType::Write), 0);
+    ASSERT_EQ(buffer.GetOccupancy(), 2);
+
+    // The first store retires at cycle 3 and the second one at cycle 6
+    for (int i = 0; i < 3; ++i) buffer.Tick();
+    ASSERT_EQ(buffer.GetOccupancy(), 1);
+    for (int i = 0; i < 3; ++i) buffer.Tick();
+    ASSERT_EQ(buffer.GetOccupancy(), 0);
+}
+
+TEST(WriteBufferTest, Full)
+{
+    WriteBuffer buffer { WriteBufferConfig { 2, 3 } };
+
+    ASSERT_EQ(buffer.Access(0x10000000, AccessType::Write), 0);
+    ASSERT_EQ(buffer.Access(0x10000004, AccessType::Write), 0);
+    buffer.Tick();
+
+    // Waits until the first store retires at cycle 3
+    ASSERT_EQ(buffer.Access(0x10000008, AccessType::Write), 2);
+    ASSERT_EQ(buffer.GetOccupancy(), 2);
+
+    WriteBufferStats const& stats = buffer.GetStats();
+    ASSERT_EQ(stats.stores, 3);
+    ASSERT_EQ(stats.fullStalls, 1);
+    ASSERT_EQ(stats.fullStallCycles, 2);
+    ASSERT_EQ(stats.maxOccupancy, 2);
+}
+
+TEST(WriteBufferTest, Forwarding)
+{
+    auto        dram = std::make_shared<Dram>(DramConfig { 4, 1024, PagePolicy::Open, 3, 2, 5 });
+    WriteBuffer buffer { WriteBufferConfig { 4, 0 }, dram };
+
+    ASSERT_EQ(buffer.Access(0x10000001, AccessType::Write), 0);
+    ASSERT_EQ(buffer.Access(0x10000002, AccessType::Read), 0);
+    ASSERT_EQ(buffer.Access(0x10000004, AccessType::Read), 2);
+
+    WriteBufferStats const& stats = buffer.GetStats();
+    ASSERT_EQ(stats.loads, 2);
+    ASSERT_EQ(stats.forwardedLoads, 1);
+    ASSERT_EQ(dram->GetStats().GetAccesses(), 2);
+
+    // Retiring the store took tRCD + tCAS cycles
+    for (int i = 0; i < 4; ++i) buffer.Tick();
+    ASSERT_EQ(buffer.GetOccupancy(), 1);
+    buffer.Tick();
+    ASSERT_EQ(buffer.GetOccupancy(), 0);
+
+    buffer.Reset();
+    ASSERT_EQ(buffer.GetStats().stores, 0);
+}